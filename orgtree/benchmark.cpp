@@ -0,0 +1,889 @@
+#include "orgtree.h"
+#include "flatorgtree.h"
+#include "employeeindex.h"
+#include "orglcaindex.h"
+#include "orglevelindex.h"
+#include "orgpathindex.h"
+#include "orgbatchquery.h"
+#include "parallelorgtree.h"
+#include "dynamicorgtree.h"
+#include "orgloader.h"
+#include "orgsnapshot.h"
+#include "succinctorgtree.h"
+#include "concurrentorgtree.h"
+#include "orgquerycache.h"
+#include "orgmerkletree.h"
+#include "compactorgtree.h"
+#include "orgtraversal.h"
+#include "orgwriter.h"
+#include "employeearena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <malloc.h>     // mallinfo2, glibc
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Build a balanced organization chart with employee IDs 0 .. numEmployees - 1,
+ * numbered level by level, where every manager has up to fanout direct reports.
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ * @param arena - Arena to build the chart in, nullptr to allocate every employee with new
+ * @return the head of the chart
+ */
+Employee* buildBalancedOrg(int numEmployees, int fanout, EmployeeArena* arena = nullptr) {
+    Employee* head = (arena != nullptr) ? arena->newEmployee(0) : new Employee(0);
+    vector<Employee*> managers(1, head);
+    int nextID = 1;
+
+    // Hand out direct reports to the managers in level order
+    for (size_t m = 0; m < managers.size() && nextID < numEmployees; m++) {
+        vector<int> reportIDs;
+        for (int i = 0; i < fanout && nextID < numEmployees; i++) {
+            reportIDs.push_back(nextID++);
+        }
+        managers[m]->addDirectReports(reportIDs);
+
+        const vector<Employee*> &reports = managers[m]->getDirectReports();
+        managers.insert(managers.end(), reports.begin(), reports.end());
+    }
+    return head;
+}
+
+/**
+ * Deallocate a chart without printing anything, using an explicit stack
+ * @param head - The head of the chart
+ */
+void freeOrg(Employee* head) {
+    vector<Employee*> toDelete;
+    if (head != nullptr) {
+        toDelete.push_back(head);
+    }
+    while (!toDelete.empty()) {
+        Employee* employee = toDelete.back();
+        toDelete.pop_back();
+        const vector<Employee*> &reports = employee->getDirectReports();
+        toDelete.insert(toDelete.end(), reports.begin(), reports.end());
+        delete employee;
+    }
+}
+
+/**
+ * Run query(i) for i = 0 .. numQueries - 1 and print the average time per query
+ * @param name - Description of the query
+ * @param numQueries - Number of queries to run
+ * @param query - Callable taking the query number and returning a value to check
+ */
+template <typename Query>
+void timeQueries(string name, int numQueries, Query query) {
+    long long checksum = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < numQueries; i++) {
+        checksum += query(i);
+    }
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    double ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    cout << "  " << name << ": " << ns / numQueries << " ns/query"
+         << " (checksum " << checksum << ")" << endl;
+}
+
+// Spread query IDs over the whole chart with a multiplicative hash
+int queryID(int i, int numEmployees) {
+    return (int)(((long long)i * 2654435761LL) % numEmployees);
+}
+
+/**
+ * Compare the Orgtree queries with the FlatOrgtree queries on a balanced chart
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkFlatOrgtree(int numEmployees, int fanout) {
+    const int TREE_QUERIES = 20;        // Orgtree queries walk the whole chart
+    const int FLAT_QUERIES = 1000000;
+    const int MISSING_ID = -2;
+
+    cout << "Balanced chart, " << numEmployees << " employees, fanout " << fanout << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    FlatOrgtree flat(head);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    cout << "  FlatOrgtree build: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    timeQueries("Orgtree::isEmployeePresentInOrg hit", TREE_QUERIES, [&](int i) {
+        return (int)Orgtree::isEmployeePresentInOrg(head, queryID(i, numEmployees));
+    });
+    timeQueries("FlatOrgtree::isEmployeePresentInOrg hit", FLAT_QUERIES, [&](int i) {
+        return (int)flat.isEmployeePresentInOrg(queryID(i, numEmployees));
+    });
+    timeQueries("Orgtree::isEmployeePresentInOrg miss", TREE_QUERIES, [&](int i) {
+        return (int)Orgtree::isEmployeePresentInOrg(head, MISSING_ID);
+    });
+    timeQueries("FlatOrgtree::isEmployeePresentInOrg miss", FLAT_QUERIES, [&](int i) {
+        return (int)flat.isEmployeePresentInOrg(MISSING_ID);
+    });
+
+    EmployeeIndex index(head);
+    timeQueries("EmployeeIndex::isEmployeePresentInOrg hit", FLAT_QUERIES, [&](int i) {
+        return (int)index.isEmployeePresentInOrg(queryID(i, numEmployees));
+    });
+    timeQueries("EmployeeIndex::isEmployeePresentInOrg miss", FLAT_QUERIES, [&](int i) {
+        return (int)index.isEmployeePresentInOrg(MISSING_ID);
+    });
+
+    timeQueries("Orgtree::findManagersOfEmployee", TREE_QUERIES, [&](int i) {
+        vector<int> managers;
+        Orgtree::findManagersOfEmployee(head, queryID(i, numEmployees), managers);
+        return (int)managers.size();
+    });
+    timeQueries("FlatOrgtree::findManagersOfEmployee", FLAT_QUERIES, [&](int i) {
+        vector<int> managers;
+        flat.findManagersOfEmployee(queryID(i, numEmployees), managers);
+        return (int)managers.size();
+    });
+
+    timeQueries("FlatOrgtree::getManagerChain, first manager below " + to_string(fanout), FLAT_QUERIES, [&](int i) {
+        FlatOrgtree::ManagerChain chain = flat.getManagerChain(queryID(i, numEmployees));
+        FlatOrgtree::ManagerChain::const_iterator found =
+            find_if(chain.begin(), chain.end(), [&](int m_id) { return m_id < fanout; });
+        return (found == chain.end()) ? Employee::NOT_FOUND : *found;
+    });
+    timeQueries("FlatOrgtree::findKthManager, k = 2", FLAT_QUERIES, [&](int i) {
+        return flat.findKthManager(queryID(i, numEmployees), 2);
+    });
+
+    timeQueries("EmployeeIndex::findManagersOfEmployee", FLAT_QUERIES, [&](int i) {
+        vector<int> managers;
+        index.findManagersOfEmployee(queryID(i, numEmployees), managers);
+        return (int)managers.size();
+    });
+
+    timeQueries("Orgtree::findEmployeeLevel", TREE_QUERIES, [&](int i) {
+        return Orgtree::findEmployeeLevel(head, queryID(i, numEmployees), 0);
+    });
+    timeQueries("FlatOrgtree::findEmployeeLevel", FLAT_QUERIES, [&](int i) {
+        return flat.findEmployeeLevel(queryID(i, numEmployees), 0);
+    });
+
+    start = chrono::steady_clock::now();
+    OrgLevelIndex levelIndex(head);
+    end = chrono::steady_clock::now();
+    cout << "  OrgLevelIndex build: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+    timeQueries("OrgLevelIndex::findEmployeeLevel", FLAT_QUERIES, [&](int i) {
+        return levelIndex.findEmployeeLevel(queryID(i, numEmployees), 0);
+    });
+    start = chrono::steady_clock::now();
+    vector<int> headcounts = OrgLevelIndex::countEmployeesPerLevel(head);
+    end = chrono::steady_clock::now();
+    cout << "  OrgLevelIndex::countEmployeesPerLevel: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms ("
+         << headcounts.size() << " levels)" << endl;
+
+    timeQueries("Orgtree::findClosestSharedManager", TREE_QUERIES, [&](int i) {
+        Employee* shared = Orgtree::findClosestSharedManager(head, queryID(i, numEmployees),
+                                                             queryID(i + 1, numEmployees));
+        return (shared == nullptr) ? Employee::NOT_FOUND : shared->getEmployeeID();
+    });
+    timeQueries("FlatOrgtree::findClosestSharedManager", FLAT_QUERIES, [&](int i) {
+        return flat.findClosestSharedManager(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+
+    start = chrono::steady_clock::now();
+    OrgLcaIndex lcaIndex(head);
+    end = chrono::steady_clock::now();
+    cout << "  OrgLcaIndex build: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+    timeQueries("OrgLcaIndex::findClosestSharedManager", FLAT_QUERIES, [&](int i) {
+        Employee* shared = lcaIndex.findClosestSharedManager(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+        return (shared == nullptr) ? Employee::NOT_FOUND : shared->getEmployeeID();
+    });
+
+    timeQueries("Orgtree::findNumOfManagersBetween", TREE_QUERIES, [&](int i) {
+        return Orgtree::findNumOfManagersBetween(head, queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("FlatOrgtree::findNumOfManagersBetween", FLAT_QUERIES, [&](int i) {
+        return flat.findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("OrgLcaIndex::findNumOfManagersBetween", FLAT_QUERIES, [&](int i) {
+        return lcaIndex.findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+
+    start = chrono::steady_clock::now();
+    OrgPathIndex pathIndex(head);
+    end = chrono::steady_clock::now();
+    cout << "  OrgPathIndex build: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+    timeQueries("OrgPathIndex::findClosestSharedManager", FLAT_QUERIES, [&](int i) {
+        return pathIndex.findClosestSharedManager(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("OrgPathIndex::findPathAggregate", FLAT_QUERIES, [&](int i) {
+        OrgPathIndex::PathAggregate aggregate = { 0, 0, 0, 0 };
+        pathIndex.findPathAggregate(queryID(i, numEmployees), queryID(i + 1, numEmployees), aggregate);
+        return aggregate.count;
+    });
+    timeQueries("OrgPathIndex::setAttribute", FLAT_QUERIES, [&](int i) {
+        return (int)pathIndex.setAttribute(queryID(i, numEmployees), i);
+    });
+
+    // Subtree queries: the manager check with Orgtree needs the whole chain of managers
+    timeQueries("Orgtree::findManagersOfEmployee as a manager check", TREE_QUERIES, [&](int i) {
+        vector<int> managers;
+        Orgtree::findManagersOfEmployee(head, queryID(i, numEmployees), managers);
+        return (int)(find(managers.begin(), managers.end(), i % fanout) != managers.end());
+    });
+    timeQueries("FlatOrgtree::isManagerOf", FLAT_QUERIES, [&](int i) {
+        return (int)flat.isManagerOf(i % fanout, queryID(i, numEmployees));
+    });
+    timeQueries("FlatOrgtree::findNumOfEmployeesUnder", FLAT_QUERIES, [&](int i) {
+        return flat.findNumOfEmployeesUnder(queryID(i, numEmployees));
+    });
+
+    // A batch of pairs answered offline, compared with one OrgLcaIndex query per pair
+    const int BATCH_PAIRS = 5000000;
+    vector<pair<int, int> > pairs(BATCH_PAIRS);
+    for (int i = 0; i < BATCH_PAIRS; i++) {
+        pairs[i] = make_pair(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    }
+    for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+        start = chrono::steady_clock::now();
+        vector<int> numManagers = OrgBatchQuery::findNumOfManagersBetween(flat, pairs, numThreads);
+        end = chrono::steady_clock::now();
+        double ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+        cout << "  OrgBatchQuery::findNumOfManagersBetween, " << numThreads << " threads: "
+             << ns / BATCH_PAIRS << " ns/pair" << endl;
+    }
+
+    freeOrg(head);
+}
+
+/**
+ * Compare the serial Orgtree searches with ParallelOrgtree on 1 to 64 threads
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkParallelOrgtree(int numEmployees, int fanout) {
+    const int QUERIES = 5;
+    const int MISSING_ID = -2;
+
+    cout << "Balanced chart, " << numEmployees << " employees, fanout " << fanout
+         << ", " << thread::hardware_concurrency() << " cores" << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+
+    timeQueries("Orgtree::isEmployeePresentInOrg miss", QUERIES, [&](int i) {
+        return (int)Orgtree::isEmployeePresentInOrg(head, MISSING_ID);
+    });
+    timeQueries("Orgtree::findEmployeeLevel", QUERIES, [&](int i) {
+        return Orgtree::findEmployeeLevel(head, queryID(i, numEmployees), 0);
+    });
+
+    for (int numThreads = 1; numThreads <= 64; numThreads *= 2) {
+        ParallelOrgtree parallel(numThreads);
+        string threads = ", " + to_string(numThreads) + " threads";
+
+        timeQueries("ParallelOrgtree::isEmployeePresentInOrg miss" + threads, QUERIES, [&](int i) {
+            return (int)parallel.isEmployeePresentInOrg(head, MISSING_ID);
+        });
+        timeQueries("ParallelOrgtree::findEmployeeLevel" + threads, QUERIES, [&](int i) {
+            return parallel.findEmployeeLevel(head, queryID(i, numEmployees), 0);
+        });
+        timeQueries("ParallelOrgtree::countEmployees" + threads, QUERIES, [&](int i) {
+            return (int)parallel.countEmployees(head);
+        });
+    }
+
+    freeOrg(head);
+}
+
+/**
+ * Time DynamicOrgtree queries and reorgs on a balanced chart
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkDynamicOrgtree(int numEmployees, int fanout) {
+    const int QUERIES = 1000000;
+
+    cout << "Balanced chart, " << numEmployees << " employees, fanout " << fanout << ", with reorgs" << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    DynamicOrgtree dynamic(head);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    cout << "  DynamicOrgtree build: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+    freeOrg(head);
+
+    timeQueries("DynamicOrgtree::findNumOfManagersBetween", QUERIES, [&](int i) {
+        return dynamic.findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("DynamicOrgtree::moveEmployee", QUERIES, [&](int i) {
+        return (int)dynamic.moveEmployee(queryID(2 * i + 7, numEmployees), queryID(3 * i + 5, numEmployees));
+    });
+    timeQueries("DynamicOrgtree::findNumOfManagersBetween after the moves", QUERIES, [&](int i) {
+        return dynamic.findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("DynamicOrgtree::removeEmployee and addEmployee", QUERIES / 2, [&](int i) {
+        int e_id = queryID(i, numEmployees);
+        int m_id = dynamic.getManagerID(e_id);
+        return (int)(m_id != Employee::NOT_FOUND && dynamic.removeEmployee(e_id) && dynamic.addEmployee(e_id, m_id));
+    });
+}
+
+/**
+ * Time loading a balanced chart from CSV and binary edge files, in rows per second
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkOrgLoader(int numEmployees, int fanout) {
+    const string csvPath = "benchmark_edges.csv";
+    const string binaryPath = "benchmark_edges.bin";
+
+    cout << "Edge files, " << numEmployees << " rows" << endl;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    cout << "  Building with addDirectReports: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    if (!OrgLoader::writeEdges(head, csvPath, false) || !OrgLoader::writeEdges(head, binaryPath, true)) {
+        cout << "  Cannot write the edge files" << endl;
+        freeOrg(head);
+        return;
+    }
+    freeOrg(head);
+
+    for (int binary = 0; binary <= 1; binary++) {
+        for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+            start = chrono::steady_clock::now();
+            Employee* loaded = binary ? OrgLoader::loadBinary(binaryPath, numThreads)
+                                      : OrgLoader::loadCsv(csvPath, numThreads);
+            end = chrono::steady_clock::now();
+
+            double seconds = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1e6;
+            cout << "  OrgLoader::" << (binary ? "loadBinary" : "loadCsv") << ", " << numThreads << " threads: "
+                 << (loaded == nullptr ? 0 : (long long)(numEmployees / seconds)) << " rows/s" << endl;
+            freeOrg(loaded);
+        }
+    }
+    remove(csvPath.c_str());
+    remove(binaryPath.c_str());
+}
+
+/**
+ * Time opening a snapshot of a balanced chart, against building the query structures from scratch
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkOrgSnapshot(int numEmployees, int fanout) {
+    const string path = "benchmark_snapshot.bin";
+    const int QUERIES = 1000000;
+
+    cout << "Snapshot, " << numEmployees << " employees" << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    FlatOrgtree flat(head);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    cout << "  FlatOrgtree build from the Employee tree: "
+         << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us" << endl;
+    freeOrg(head);
+
+    start = chrono::steady_clock::now();
+    bool written = OrgSnapshot::write(flat, path);
+    end = chrono::steady_clock::now();
+    cout << "  OrgSnapshot::write: "
+         << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us" << endl;
+    if (!written) {
+        cout << "  Cannot write the snapshot" << endl;
+        return;
+    }
+
+    for (int verify = 0; verify <= 1; verify++) {
+        start = chrono::steady_clock::now();
+        OrgSnapshot* snapshot = OrgSnapshot::open(path, verify == 1);
+        end = chrono::steady_clock::now();
+        cout << "  OrgSnapshot::open" << (verify ? " with checksum" : "") << ": "
+             << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us" << endl;
+
+        timeQueries("OrgSnapshot::findNumOfManagersBetween", QUERIES, [&](int i) {
+            return snapshot->findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+        });
+        delete snapshot;
+    }
+    remove(path.c_str());
+}
+
+/**
+ * Compare the size and query times of SuccinctOrgtree with FlatOrgtree
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkSuccinctOrgtree(int numEmployees, int fanout) {
+    const int QUERIES = 1000000;
+
+    cout << "SuccinctOrgtree, " << numEmployees << " employees, fanout " << fanout << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+    FlatOrgtree flat(head);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    SuccinctOrgtree succinct(head);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    freeOrg(head);
+    cout << "  SuccinctOrgtree build: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+    cout << "  Tree: " << 8.0 * succinct.getTreeBytes() / numEmployees << " bits/employee, IDs: "
+         << 8.0 * succinct.getIDBytes() / numEmployees << " bits/employee" << endl;
+
+    timeQueries("FlatOrgtree::findEmployeeLevel", QUERIES, [&](int i) {
+        return flat.findEmployeeLevel(queryID(i, numEmployees), 0);
+    });
+    timeQueries("SuccinctOrgtree::findEmployeeLevel", QUERIES, [&](int i) {
+        return succinct.findEmployeeLevel(queryID(i, numEmployees), 0);
+    });
+    timeQueries("FlatOrgtree::findClosestSharedManager", QUERIES, [&](int i) {
+        return flat.findClosestSharedManager(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("SuccinctOrgtree::findClosestSharedManager", QUERIES, [&](int i) {
+        return succinct.findClosestSharedManager(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("FlatOrgtree::isManagerOf", QUERIES, [&](int i) {
+        return (int)flat.isManagerOf(i % fanout, queryID(i, numEmployees));
+    });
+    timeQueries("SuccinctOrgtree::isManagerOf", QUERIES, [&](int i) {
+        return (int)succinct.isManagerOf(i % fanout, queryID(i, numEmployees));
+    });
+    timeQueries("SuccinctOrgtree::findNumOfEmployeesUnder", QUERIES, [&](int i) {
+        return succinct.findNumOfEmployeesUnder(queryID(i, numEmployees));
+    });
+}
+
+/**
+ * Time OrgQueryCache on a small set of repeated queries, the pattern of a UI showing a chart
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkOrgQueryCache(int numEmployees, int fanout) {
+    const int TREE_QUERIES = 20;        // Orgtree queries walk the whole chart
+    const int CACHED_QUERIES = 1000000;
+    const int HOT_PAIRS = 64;           // distinct pairs asked over and over, the first ask of each walks the chart
+
+    cout << "OrgQueryCache, " << numEmployees << " employees, fanout " << fanout << ", "
+         << HOT_PAIRS << " repeated pairs" << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+    OrgQueryCache cache(head);
+
+    timeQueries("Orgtree::findNumOfManagersBetween", TREE_QUERIES, [&](int i) {
+        return Orgtree::findNumOfManagersBetween(head, queryID(i % HOT_PAIRS, numEmployees),
+                                                 queryID(i % HOT_PAIRS + 1, numEmployees));
+    });
+    timeQueries("OrgQueryCache, first ask of every pair", 2 * HOT_PAIRS, [&](int i) {
+        int e1 = queryID(i / 2, numEmployees), e2 = queryID(i / 2 + 1, numEmployees);
+        return (i % 2 == 0) ? cache.findNumOfManagersBetween(e1, e2)
+                            : cache.findClosestSharedManager(e1, e2)->getEmployeeID();
+    });
+    timeQueries("OrgQueryCache::findNumOfManagersBetween", CACHED_QUERIES, [&](int i) {
+        return cache.findNumOfManagersBetween(queryID(i % HOT_PAIRS, numEmployees),
+                                              queryID(i % HOT_PAIRS + 1, numEmployees));
+    });
+    timeQueries("OrgQueryCache::findClosestSharedManager", CACHED_QUERIES, [&](int i) {
+        return cache.findClosestSharedManager(queryID(i % HOT_PAIRS, numEmployees),
+                                              queryID(i % HOT_PAIRS + 1, numEmployees))->getEmployeeID();
+    });
+    cout << "  Hit rate: " << cache.getHitRate() << ", evictions: " << cache.getNumEvictions() << endl;
+
+    head->addDirectReport(numEmployees);
+    timeQueries("OrgQueryCache::findNumOfManagersBetween after a change", TREE_QUERIES, [&](int i) {
+        return cache.findNumOfManagersBetween(queryID(i % HOT_PAIRS, numEmployees),
+                                              queryID(i % HOT_PAIRS + 1, numEmployees));
+    });
+    cout << "  Invalidations: " << cache.getNumInvalidations() << endl;
+    freeOrg(head);
+}
+
+/**
+ * Time ConcurrentOrgtree snapshot reads, alone and while a writer thread keeps publishing
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkConcurrentOrgtree(int numEmployees, int fanout) {
+    const int QUERIES = 1000000;
+    const int PUBLISHES = 10;
+
+    cout << "ConcurrentOrgtree, " << numEmployees << " employees" << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+    ConcurrentOrgtree org(head);
+    freeOrg(head);
+
+    timeQueries("Snapshot and findNumOfManagersBetween", QUERIES, [&](int i) {
+        ConcurrentOrgtree::Snapshot snapshot(org);
+        return snapshot->findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int p = 0; p < PUBLISHES; p++) {
+        org.addDirectReport(0, numEmployees + p);
+        org.publish();
+    }
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    cout << "  ConcurrentOrgtree::publish: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() / PUBLISHES << " ms" << endl;
+
+    // The same reads with a writer publishing a new version as fast as it can
+    atomic<bool> readersDone(false);
+    atomic<int> numPublished(0);
+    thread writer([&]() {
+        for (int p = PUBLISHES; !readersDone.load(); p++) {
+            org.addDirectReport(0, numEmployees + p);
+            org.publish();
+            numPublished++;
+        }
+    });
+    timeQueries("Snapshot and findNumOfManagersBetween during publishes", QUERIES, [&](int i) {
+        ConcurrentOrgtree::Snapshot snapshot(org);
+        return snapshot->findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    readersDone.store(true);
+    writer.join();
+    cout << "  Versions published during the reads: " << numPublished.load() << endl;
+}
+
+// Discards everything written to it, to time deleteOrgtree without its trace
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) {
+        return c;
+    }
+};
+
+/**
+ * Time one run of a function and print how long it took
+ * @param name - Description of the function
+ * @param run - Callable returning a value to check
+ */
+template <typename Run>
+void timeOnce(string name, Run run) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    long long checksum = run();
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    cout << "  " << name << ": " << chrono::duration_cast<chrono::milliseconds>(end - start).count()
+         << " ms (checksum " << checksum << ")" << endl;
+}
+
+/**
+ * Time building a balanced chart and tearing it down, with employees allocated one by one
+ * with new and with an EmployeeArena
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkEmployeeArena(int numEmployees, int fanout) {
+    cout << "EmployeeArena, " << numEmployees << " employees, fanout " << fanout << endl;
+
+    Employee* head = nullptr;
+    timeOnce("Heap build", [&]() {
+        head = buildBalancedOrg(numEmployees, fanout);
+        return (long long)head->getDirectReports().size();
+    });
+    NullBuffer nullBuffer;
+    ostream nullStream(&nullBuffer);
+    timeOnce("Orgtree::deleteOrgtree with trace", [&]() {
+        Orgtree::deleteOrgtree(head, &nullStream);
+        return 0LL;
+    });
+
+    timeOnce("Heap build", [&]() {
+        head = buildBalancedOrg(numEmployees, fanout);
+        return (long long)head->getDirectReports().size();
+    });
+    timeOnce("Orgtree::deleteOrgtree without trace", [&]() {
+        Orgtree::deleteOrgtree(head, nullptr);
+        return 0LL;
+    });
+
+    EmployeeArena arena;
+    timeOnce("Arena build", [&]() {
+        head = buildBalancedOrg(numEmployees, fanout, &arena);
+        return (long long)arena.size();
+    });
+    timeOnce("EmployeeArena::release", [&]() {
+        arena.release();
+        return (long long)arena.size();
+    });
+}
+
+/**
+ * Time OrgMerkleTree finding a few new employees in a new export of a chart, and updating
+ * a DynamicOrgtree with them instead of rebuilding it
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkOrgMerkleTree(int numEmployees, int fanout) {
+    const int NEW_EMPLOYEES = 100;
+
+    cout << "OrgMerkleTree, " << numEmployees << " employees, fanout " << fanout << ", "
+         << NEW_EMPLOYEES << " new employees" << endl;
+    Employee* before = buildBalancedOrg(numEmployees, fanout);
+    Employee* after = buildBalancedOrg(numEmployees, fanout);
+    {
+        EmployeeIndex index(after);
+        for (int i = 0; i < NEW_EMPLOYEES; i++) {
+            index.findEmployee(queryID(i, numEmployees))->addDirectReport(numEmployees + i);
+        }
+    }
+
+    OrgMerkleTree* oldHashes = nullptr;
+    OrgMerkleTree* newHashes = nullptr;
+    timeOnce("OrgMerkleTree build", [&]() {
+        oldHashes = new OrgMerkleTree(before);
+        return (long long)oldHashes->size();
+    });
+    newHashes = new OrgMerkleTree(after);
+
+    OrgMerkleTree::Diff changes;
+    timeOnce("OrgMerkleTree::diff", [&]() {
+        OrgMerkleTree::diff(*oldHashes, *newHashes, changes);
+        return (long long)changes.inserts.size();
+    });
+    cout << "  Employees looked at: " << changes.numVisited << endl;
+
+    DynamicOrgtree org(before);
+    timeOnce("OrgMerkleTree::applyChanges to a DynamicOrgtree", [&]() {
+        return (long long)OrgMerkleTree::applyChanges(changes, org);
+    });
+    timeOnce("DynamicOrgtree rebuild", [&]() {
+        DynamicOrgtree rebuilt(after);
+        return (long long)rebuilt.size();
+    });
+
+    delete oldHashes;
+    delete newHashes;
+    freeOrg(before);
+    freeOrg(after);
+}
+
+// Bytes currently allocated from the heap, including blocks mapped for large allocations
+size_t heapBytes() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+/**
+ * Compare the memory and the query and traversal times of an Employee tree and a CompactOrgtree
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkCompactOrgtree(int numEmployees, int fanout) {
+    const int QUERIES = 5;      // every query scans or walks the whole chart
+    const int MISSING_ID = -2;
+
+    cout << "CompactOrgtree, " << numEmployees << " employees, fanout " << fanout << endl;
+    size_t startBytes = heapBytes();
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+    size_t treeBytes = heapBytes() - startBytes;
+
+    CompactOrgtree* compact = nullptr;
+    timeOnce("CompactOrgtree build", [&]() {
+        compact = new CompactOrgtree(head);
+        return (long long)compact->size();
+    });
+    size_t compactBytes = heapBytes() - startBytes - treeBytes;
+    cout << "  Employee tree: " << (double)treeBytes / numEmployees << " bytes/employee, CompactOrgtree: "
+         << (double)compactBytes / numEmployees << " bytes/employee" << endl;
+
+    timeQueries("Orgtree::isEmployeePresentInOrg miss (depth-first walk)", QUERIES, [&](int i) {
+        return (int)Orgtree::isEmployeePresentInOrg(head, MISSING_ID);
+    });
+    timeQueries("CompactOrgtree::isEmployeePresentInOrg miss (ID scan)", QUERIES, [&](int i) {
+        return (int)compact->isEmployeePresentInOrg(MISSING_ID);
+    });
+    timeQueries("CompactOrgtree::findNumOfEmployeesUnder head (depth-first walk)", QUERIES, [&](int i) {
+        return compact->findNumOfEmployeesUnder(0);
+    });
+    timeQueries("Orgtree::findNumOfManagersBetween", QUERIES, [&](int i) {
+        return Orgtree::findNumOfManagersBetween(head, queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+    timeQueries("CompactOrgtree::findNumOfManagersBetween", QUERIES, [&](int i) {
+        return compact->findNumOfManagersBetween(queryID(i, numEmployees), queryID(i + 1, numEmployees));
+    });
+
+    delete compact;
+    freeOrg(head);
+}
+
+/**
+ * Compare OrgTraversal with a hand-written walk, and OrgWriter with writing every employee
+ * to a stream, by writing the chart as "employee,manager" lines
+ * @param numEmployees - Number of employees in the chart
+ * @param fanout - Number of direct reports of each manager
+ */
+void benchmarkOrgTraversal(int numEmployees, int fanout) {
+    const string path = "benchmark_edges.csv";
+
+    cout << "OrgTraversal, " << numEmployees << " employees, fanout " << fanout << endl;
+    Employee* head = buildBalancedOrg(numEmployees, fanout);
+
+    timeOnce("Hand-written explicit stack walk", [&]() {
+        long long sum = 0;
+        vector<Employee*> toVisit(1, head);
+        while (!toVisit.empty()) {
+            Employee* employee = toVisit.back();
+            toVisit.pop_back();
+            sum += employee->getEmployeeID();
+            const vector<Employee*> &directReports = employee->getDirectReports();
+            toVisit.insert(toVisit.end(), directReports.begin(), directReports.end());
+        }
+        return sum;
+    });
+    timeOnce("OrgTraversal::preOrder", [&]() {
+        long long sum = 0;
+        OrgTraversal::preOrder(head, [&sum](Employee* employee, int) {
+            sum += employee->getEmployeeID();
+            return CONTINUE;
+        });
+        return sum;
+    });
+    timeOnce("OrgTraversal::postOrder", [&]() {
+        long long sum = 0;
+        OrgTraversal::postOrder(head, [&sum](Employee* employee, int) {
+            sum += employee->getEmployeeID();
+            return CONTINUE;
+        });
+        return sum;
+    });
+    timeOnce("OrgTraversal::levelOrder", [&]() {
+        long long sum = 0;
+        OrgTraversal::levelOrder(head, [&sum](Employee* employee, int) {
+            sum += employee->getEmployeeID();
+            return CONTINUE;
+        });
+        return sum;
+    });
+
+    auto managerID = [](Employee* employee, int level) {
+        return (level == 0) ? Employee::EMPTY_EMPLOYEEID : employee->getManager()->getEmployeeID();
+    };
+    timeOnce("Edges to memory, ostream << per employee", [&]() {
+        ostringstream stream;
+        OrgTraversal::preOrder(head, [&](Employee* employee, int level) {
+            stream << employee->getEmployeeID() << ',' << managerID(employee, level) << '\n';
+            return CONTINUE;
+        });
+        return (long long)stream.str().size();
+    });
+    timeOnce("Edges to memory, OrgWriter to a MemorySink", [&]() {
+        MemorySink memory;
+        OrgWriter writer(memory);
+        OrgTraversal::preOrder(head, [&](Employee* employee, int level) {
+            writer.writeInt(employee->getEmployeeID());
+            writer.writeChar(',');
+            writer.writeInt(managerID(employee, level));
+            writer.writeChar('\n');
+            return CONTINUE;
+        });
+        writer.flush();
+        return (long long)memory.getContents().size();
+    });
+    timeOnce("Edges to a file, ofstream << per employee", [&]() {
+        ofstream file(path.c_str());
+        OrgTraversal::preOrder(head, [&](Employee* employee, int level) {
+            file << employee->getEmployeeID() << ',' << managerID(employee, level) << '\n';
+            return CONTINUE;
+        });
+        file.close();
+        return (long long)file.good();
+    });
+    timeOnce("Edges to a file, OrgLoader::writeEdges (OrgWriter to a FileSink)", [&]() {
+        return (long long)OrgLoader::writeEdges(head, path, false);
+    });
+    remove(path.c_str());
+
+    freeOrg(head);
+}
+
+/**
+ * Time the Orgtree functions on a chain, the deepest chart possible,
+ * where every employee has exactly one direct report
+ * @param depth - Number of employees in the chain
+ */
+void benchmarkDeepChain(int depth) {
+    cout << "Chain, " << depth << " employees" << endl;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Employee* head = new Employee(0);
+    Employee* bottom = head;
+    for (int i = 1; i < depth; i++) {
+        bottom->addDirectReport(i);
+        bottom = bottom->getDirectReports().back();
+    }
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    cout << "  Chain build: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+
+    timeOnce("Orgtree::isEmployeePresentInOrg bottom", [&]() {
+        return (long long)Orgtree::isEmployeePresentInOrg(head, depth - 1);
+    });
+    timeOnce("Orgtree::findManagersOfEmployee bottom", [&]() {
+        vector<int> managers;
+        Orgtree::findManagersOfEmployee(head, depth - 1, managers);
+        return (long long)managers.size();
+    });
+    timeOnce("Orgtree::findEmployeeLevel bottom", [&]() {
+        return (long long)Orgtree::findEmployeeLevel(head, depth - 1, 0);
+    });
+    timeOnce("Orgtree::findClosestSharedManager bottom and middle", [&]() {
+        return (long long)Orgtree::findClosestSharedManager(head, depth - 1, depth / 2)->getEmployeeID();
+    });
+    timeOnce("Orgtree::findNumOfManagersBetween head and bottom", [&]() {
+        return (long long)Orgtree::findNumOfManagersBetween(head, 0, depth - 1);
+    });
+
+    FlatOrgtree flat(head);
+    timeOnce("FlatOrgtree::findKthManager bottom, k = depth / 2", [&]() {
+        return (long long)flat.findKthManager(depth - 1, depth / 2);
+    });
+
+    // Delete in post order as usual, with the trace going nowhere
+    NullBuffer nullBuffer;
+    streambuf* coutBuffer = cout.rdbuf(&nullBuffer);
+    start = chrono::steady_clock::now();
+    Orgtree::deleteOrgtree(head);
+    end = chrono::steady_clock::now();
+    cout.rdbuf(coutBuffer);
+    cout << "  Orgtree::deleteOrgtree: "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+}
+
+// Usage: ./benchmark [number of employees] [chain depth], e.g. ./benchmark 10000000 10000000
+int main(int argc, char **argv) {
+    int numEmployees = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int chainDepth = (argc > 2) ? atoi(argv[2]) : 10000000;
+
+    benchmarkFlatOrgtree(numEmployees, 8);
+    benchmarkParallelOrgtree(numEmployees, 8);
+    benchmarkDynamicOrgtree(numEmployees, 8);
+    benchmarkOrgLoader(numEmployees, 8);
+    benchmarkOrgSnapshot(numEmployees, 8);
+    benchmarkSuccinctOrgtree(numEmployees, 8);
+    benchmarkOrgQueryCache(numEmployees, 8);
+    benchmarkOrgMerkleTree(numEmployees, 8);
+    benchmarkCompactOrgtree(numEmployees, 3);
+    benchmarkOrgTraversal(numEmployees, 8);
+    benchmarkConcurrentOrgtree(numEmployees, 8);
+    benchmarkEmployeeArena(numEmployees, 8);
+    benchmarkDeepChain(chainDepth);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,250 @@
+#include "orgtree.h"
+
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/resource.h>   // getrusage
+#include <vector>
+
+using namespace std;
+
+// Every allocation made through new in this program, to report allocations per query.
+// The suite is single-threaded, so a plain counter is enough.
+static long long numAllocations = 0;
+
+void* operator new(size_t size) {
+    numAllocations++;
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+// Shapes of the generated charts
+enum Shape { BALANCED, CHAIN, STAR, RANDOM, SKEWED };
+
+const Shape SHAPES[] = { BALANCED, CHAIN, STAR, RANDOM, SKEWED };
+
+string shapeName(Shape shape) {
+    switch (shape) {
+    case BALANCED: return "balanced 8-ary";
+    case CHAIN:    return "deep chain";
+    case STAR:     return "wide star";
+    case RANDOM:   return "random recursive";
+    default:       return "skewed fanout";
+    }
+}
+
+// A small deterministic generator, so every run builds the same charts
+struct Random {
+    unsigned long long state;
+
+    explicit Random(unsigned long long seed) : state(seed) {}
+
+    // A number in 0 .. bound - 1
+    int next(int bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (int)((state >> 33) % (unsigned long long)bound);
+    }
+};
+
+/**
+ * Generate the manager of every employee 1 .. numEmployees - 1, employee 0 being the head
+ * @param shape - Shape of the chart
+ * @param numEmployees - Number of employees in the chart
+ * @return the manager of every employee, always an employee with a smaller number, -1 for the head
+ */
+vector<int> generateManagers(Shape shape, int numEmployees) {
+    vector<int> managers(numEmployees, -1);
+    Random random(2024);
+
+    // Preferential attachment: a manager is picked with odds growing with its number of reports,
+    // which gives the few very large teams and many small ones of real organizations
+    vector<int> tickets;
+    if (shape == SKEWED) {
+        tickets.reserve(2 * (size_t)numEmployees);
+        tickets.push_back(0);
+    }
+
+    for (int i = 1; i < numEmployees; i++) {
+        switch (shape) {
+        case BALANCED: managers[i] = (i - 1) / 8; break;
+        case CHAIN:    managers[i] = i - 1; break;
+        case STAR:     managers[i] = 0; break;
+        case RANDOM:   managers[i] = random.next(i); break;
+        case SKEWED:
+            managers[i] = tickets[random.next((int)tickets.size())];
+            tickets.push_back(managers[i]);
+            tickets.push_back(i);
+            break;
+        }
+    }
+    return managers;
+}
+
+/**
+ * Build an Employee tree where employee i has ID i and reports to managers[i]
+ * @param managers - The manager of every employee, from generateManagers
+ * @return the head of the chart, employee 0
+ */
+Employee* buildOrg(const vector<int> &managers) {
+    int numEmployees = (int)managers.size();
+    if (numEmployees == 0) {
+        return nullptr;
+    }
+
+    // Group the direct reports of every manager, so each manager gets them with one call
+    vector<int> offsets(numEmployees + 1, 0);
+    for (int i = 1; i < numEmployees; i++) {
+        offsets[managers[i] + 1]++;
+    }
+    for (int i = 0; i < numEmployees; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    vector<int> reports(numEmployees - 1);
+    vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (int i = 1; i < numEmployees; i++) {
+        reports[next[managers[i]]++] = i;
+    }
+
+    // Managers always have smaller numbers than their reports, so employee i exists before its reports are added
+    vector<Employee*> employees(numEmployees, nullptr);
+    employees[0] = new Employee(0);
+    for (int i = 0; i < numEmployees; i++) {
+        if (offsets[i] == offsets[i + 1]) {
+            continue;
+        }
+        employees[i]->addDirectReports(reports.begin() + offsets[i], reports.begin() + offsets[i + 1]);
+        const vector<Employee*> &directReports = employees[i]->getDirectReports();
+        for (size_t r = 0; r < directReports.size(); r++) {
+            employees[directReports[r]->getEmployeeID()] = directReports[r];
+        }
+    }
+    return employees[0];
+}
+
+// Peak resident set size of the process so far, in megabytes
+double peakRssMegabytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;    // ru_maxrss is in kilobytes on Linux
+}
+
+/**
+ * Run query(i) for i = 0 .. numQueries - 1, then print the time and the allocations per query
+ * @param name - Description of the query
+ * @param numQueries - Number of queries to run
+ * @param query - Callable taking the query number and returning a value to check
+ */
+template <typename Query>
+void timeQueries(string name, int numQueries, Query query) {
+    long long checksum = 0;
+    long long allocationsBefore = numAllocations;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < numQueries; i++) {
+        checksum += query(i);
+    }
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    long long allocations = numAllocations - allocationsBefore;
+
+    double ns = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    printf("    %-44s %14.1f ns/query %10.2f allocs/query (checksum %lld)\n",
+           name.c_str(), ns / numQueries, (double)allocations / numQueries, checksum);
+}
+
+/**
+ * Time every Orgtree function on one generated chart, for IDs that are present (hit) and missing (miss)
+ * @param shape - Shape of the chart
+ * @param numEmployees - Number of employees in the chart
+ */
+void benchmarkShape(Shape shape, int numEmployees) {
+    const int MISSING_ID = -2;
+
+    // Every query walks up to the whole chart, so the number of queries shrinks as the chart grows
+    int numQueries = (int)min(1000LL, max(3LL, 10000000LL / numEmployees));
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Employee* head = buildOrg(generateManagers(shape, numEmployees));
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    printf("  %s, %d employees: built in %lld ms, peak RSS %.1f MB, %d queries per function\n",
+           shapeName(shape).c_str(), numEmployees,
+           (long long)chrono::duration_cast<chrono::milliseconds>(end - start).count(), peakRssMegabytes(),
+           numQueries);
+
+    // Spread hit IDs over the whole chart with a multiplicative hash
+    auto hitID = [numEmployees](int i) {
+        return (int)(((long long)i * 2654435761LL) % numEmployees);
+    };
+
+    timeQueries("isEmployeePresentInOrg hit", numQueries, [&](int i) {
+        return (long long)Orgtree::isEmployeePresentInOrg(head, hitID(i));
+    });
+    timeQueries("isEmployeePresentInOrg miss", numQueries, [&](int i) {
+        return (long long)Orgtree::isEmployeePresentInOrg(head, MISSING_ID);
+    });
+    // One result vector for all queries, so only the allocations of the query itself are counted
+    vector<int> managers;
+    timeQueries("findManagersOfEmployee hit", numQueries, [&](int i) {
+        managers.clear();
+        Orgtree::findManagersOfEmployee(head, hitID(i), managers);
+        return (long long)managers.size();
+    });
+    timeQueries("findManagersOfEmployee miss", numQueries, [&](int i) {
+        managers.clear();
+        return (long long)Orgtree::findManagersOfEmployee(head, MISSING_ID, managers);
+    });
+    timeQueries("findEmployeeLevel hit", numQueries, [&](int i) {
+        return (long long)Orgtree::findEmployeeLevel(head, hitID(i), 0);
+    });
+    timeQueries("findEmployeeLevel miss", numQueries, [&](int i) {
+        return (long long)Orgtree::findEmployeeLevel(head, MISSING_ID, 0);
+    });
+    timeQueries("findClosestSharedManager hit", numQueries, [&](int i) {
+        Employee* shared = Orgtree::findClosestSharedManager(head, hitID(i), hitID(i + 1));
+        return (long long)((shared == nullptr) ? Employee::NOT_FOUND : shared->getEmployeeID());
+    });
+    timeQueries("findClosestSharedManager miss", numQueries, [&](int i) {
+        Employee* shared = Orgtree::findClosestSharedManager(head, hitID(i), MISSING_ID);
+        return (long long)((shared == nullptr) ? Employee::NOT_FOUND : shared->getEmployeeID());
+    });
+    timeQueries("findNumOfManagersBetween hit", numQueries, [&](int i) {
+        return (long long)Orgtree::findNumOfManagersBetween(head, hitID(i), hitID(i + 1));
+    });
+    timeQueries("findNumOfManagersBetween miss", numQueries, [&](int i) {
+        return (long long)Orgtree::findNumOfManagersBetween(head, hitID(i), MISSING_ID);
+    });
+
+    start = chrono::steady_clock::now();
+    Orgtree::deleteOrgtree(head, nullptr);
+    end = chrono::steady_clock::now();
+    printf("    %-44s %14.1f ns/employee\n", "deleteOrgtree without trace",
+           (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / numEmployees);
+}
+
+// Usage: ./benchmarksuite [largest chart] [shape], e.g. ./benchmarksuite 100000000 chain
+// Runs charts of 1e3, 1e4, ... employees up to the largest chart (1e6 by default),
+// for one shape (balanced, chain, star, random or skewed) or all of them
+int main(int argc, char **argv) {
+    long long maxEmployees = (argc > 1) ? atoll(argv[1]) : 1000000;
+    string only = (argc > 2) ? argv[2] : "";
+    const string SHAPE_ARGS[] = { "balanced", "chain", "star", "random", "skewed" };
+
+    for (int s = 0; s < 5; s++) {
+        if (!only.empty() && only != SHAPE_ARGS[s]) {
+            continue;
+        }
+        cout << shapeName(SHAPES[s]) << endl;
+        for (long long n = 1000; n <= maxEmployees && n <= 1000000000LL; n *= 10) {
+            benchmarkShape(SHAPES[s], (int)n);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,254 @@
+#include "compactorgtree.h"
+
+const int CompactOrgtree::NO_INDEX;
+const int CompactOrgtree::INLINE_REPORTS;
+
+CompactOrgtree::CompactOrgtree() {
+}
+
+/**
+ * Copy the chart depth-first with an explicit stack, so every subtree takes a contiguous
+ * range of the pool and a walk over it reads the nodes in order.
+ */
+CompactOrgtree::CompactOrgtree(Employee* head) {
+    if (head == nullptr) {
+        return;
+    }
+
+    // Each stack entry is an employee still to be copied, together with its manager's handle
+    vector<pair<Employee*, int> > toCopy(1, make_pair(head, (int)NO_INDEX));
+    while (!toCopy.empty()) {
+        Employee* employee = toCopy.back().first;
+        int manager = toCopy.back().second;
+        toCopy.pop_back();
+
+        int index = (manager == NO_INDEX) ? addHead(employee->getEmployeeID())
+                                          : addDirectReport(manager, employee->getEmployeeID());
+
+        // Push the direct reports in reverse, so that the first one is copied next
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (size_t i = directReports.size(); i > 0; i--) {
+            toCopy.push_back(make_pair(directReports[i - 1], index));
+        }
+    }
+
+    // The pool grew by doubling, give back the unused part
+    nodes.shrink_to_fit();
+    ids.shrink_to_fit();
+}
+
+int CompactOrgtree::newNode(int e_id, int manager) {
+    Node node;
+    node.manager = manager;
+    node.numReports = 0;
+    nodes.push_back(node);
+    ids.push_back(e_id);
+    return (int)nodes.size() - 1;
+}
+
+// Direct report handles of a node, inline or spilled
+const int32_t* CompactOrgtree::reportsOf(int index) const {
+    const Node &node = nodes[index];
+    return (node.numReports <= INLINE_REPORTS) ? node.reports : spilled[node.reports[0]].data();
+}
+
+// Number of managers above a node
+int CompactOrgtree::depthOf(int index) const {
+    int depth = 0;
+    for (int m = nodes[index].manager; m != NO_INDEX; m = nodes[m].manager) {
+        depth++;
+    }
+    return depth;
+}
+
+int CompactOrgtree::size() const {
+    return (int)nodes.size();
+}
+
+size_t CompactOrgtree::getBytes() const {
+    size_t bytes = nodes.capacity() * sizeof(Node) + ids.capacity() * sizeof(int32_t) +
+                   spilled.capacity() * sizeof(vector<int32_t>);
+    for (size_t i = 0; i < spilled.size(); i++) {
+        bytes += spilled[i].capacity() * sizeof(int32_t);
+    }
+    return bytes;
+}
+
+int CompactOrgtree::getHead() const {
+    return nodes.empty() ? NO_INDEX : 0;
+}
+
+int CompactOrgtree::addHead(int e_id) {
+    return nodes.empty() ? newNode(e_id, NO_INDEX) : NO_INDEX;
+}
+
+/**
+ * Add a direct report, spilling the manager's list out of the node when it outgrows
+ * the inline slots.
+ */
+int CompactOrgtree::addDirectReport(int manager, int e_id) {
+    int index = newNode(e_id, manager);
+    Node &node = nodes[manager];
+    if (node.numReports < INLINE_REPORTS) {
+        node.reports[node.numReports] = index;
+    }
+    else {
+        if (node.numReports == INLINE_REPORTS) {
+            spilled.push_back(vector<int32_t>(node.reports, node.reports + INLINE_REPORTS));
+            node.reports[0] = (int32_t)spilled.size() - 1;
+        }
+        spilled[node.reports[0]].push_back(index);
+    }
+    node.numReports++;
+    return index;
+}
+
+int CompactOrgtree::getEmployeeID(int index) const {
+    return ids[index];
+}
+
+int CompactOrgtree::getManager(int index) const {
+    return nodes[index].manager;
+}
+
+int CompactOrgtree::getNumDirectReports(int index) const {
+    return nodes[index].numReports;
+}
+
+int CompactOrgtree::getDirectReport(int index, int i) const {
+    return reportsOf(index)[i];
+}
+
+int CompactOrgtree::indexOf(int e_id) const {
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (ids[i] == e_id) {
+            return (int)i;
+        }
+    }
+    return NO_INDEX;
+}
+
+Employee* CompactOrgtree::buildOrgtree() const {
+    if (nodes.empty()) {
+        return nullptr;
+    }
+
+    Employee* copyHead = new Employee(ids[0]);
+    vector<pair<Employee*, int> > toCopy(1, make_pair(copyHead, 0));
+    while (!toCopy.empty()) {
+        Employee* employee = toCopy.back().first;
+        int index = toCopy.back().second;
+        toCopy.pop_back();
+
+        const int32_t* reports = reportsOf(index);
+        int numReports = nodes[index].numReports;
+        for (int i = 0; i < numReports; i++) {
+            employee->addDirectReport(ids[reports[i]]);
+        }
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (int i = 0; i < numReports; i++) {
+            toCopy.push_back(make_pair(directReports[i], (int)reports[i]));
+        }
+    }
+    return copyHead;
+}
+
+bool CompactOrgtree::isEmployeePresentInOrg(int e_id) const {
+    return indexOf(e_id) != NO_INDEX;
+}
+
+bool CompactOrgtree::findManagersOfEmployee(int e_id, vector<int> &managers) const {
+    int index = indexOf(e_id);
+    if (index == NO_INDEX) {
+        return false;
+    }
+    for (int m = nodes[index].manager; m != NO_INDEX; m = nodes[m].manager) {
+        managers.push_back(ids[m]);
+    }
+    return true;
+}
+
+int CompactOrgtree::findEmployeeLevel(int e_id, int headLevel) const {
+    int index = indexOf(e_id);
+    return (index == NO_INDEX) ? Employee::NOT_FOUND : headLevel + depthOf(index);
+}
+
+int CompactOrgtree::findClosestSharedManager(int e1_id, int e2_id) const {
+    int e1_index = indexOf(e1_id);
+    int e2_index = indexOf(e2_id);
+
+    if (e1_index == NO_INDEX && e2_index == NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+    if (e2_index == NO_INDEX) {
+        return e1_id;
+    }
+    if (e1_index == NO_INDEX) {
+        return e2_id;
+    }
+
+    // Bring both to the same level, then climb together until they meet
+    int depth1 = depthOf(e1_index);
+    int depth2 = depthOf(e2_index);
+    for (; depth1 > depth2; depth1--) {
+        e1_index = nodes[e1_index].manager;
+    }
+    for (; depth2 > depth1; depth2--) {
+        e2_index = nodes[e2_index].manager;
+    }
+    while (e1_index != e2_index) {
+        e1_index = nodes[e1_index].manager;
+        e2_index = nodes[e2_index].manager;
+    }
+    return ids[e1_index];
+}
+
+/**
+ * Calculate the number of managers between employee e1 and employee e2:
+ * number of edges between e1 and closest shared manager +
+ * number of edges between e2 and closest shared manager - 1
+ */
+int CompactOrgtree::findNumOfManagersBetween(int e1_id, int e2_id) const {
+    int e1_index = indexOf(e1_id);
+    int e2_index = indexOf(e2_id);
+    if (e1_index == NO_INDEX || e2_index == NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+
+    int depth1 = depthOf(e1_index);
+    int depth2 = depthOf(e2_index);
+    int numEdges = 0;
+    for (; depth1 > depth2; depth1--, numEdges++) {
+        e1_index = nodes[e1_index].manager;
+    }
+    for (; depth2 > depth1; depth2--, numEdges++) {
+        e2_index = nodes[e2_index].manager;
+    }
+    while (e1_index != e2_index) {
+        e1_index = nodes[e1_index].manager;
+        e2_index = nodes[e2_index].manager;
+        numEdges += 2;
+    }
+    return numEdges - 1;
+}
+
+int CompactOrgtree::findNumOfEmployeesUnder(int e_id) const {
+    int index = indexOf(e_id);
+    if (index == NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+
+    int count = 0;
+    vector<int32_t> toVisit(1, index);
+    while (!toVisit.empty()) {
+        int next = toVisit.back();
+        toVisit.pop_back();
+        int numReports = nodes[next].numReports;
+        const int32_t* reports = reportsOf(next);
+        for (int i = 0; i < numReports; i++) {
+            toVisit.push_back(reports[i]);
+        }
+        count += numReports;
+    }
+    return count;
+}
@@ -0,0 +1,123 @@
+#ifndef COMPACTORGTREE_H
+#define COMPACTORGTREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "orgtree.h"
+
+using namespace std;
+
+// An organization chart stored in a node pool, for charts where most employees have only
+// a few direct reports.
+//
+// Every employee is a fixed-size node in one vector, addressed by a 32-bit handle (its
+// index in the pool) instead of a pointer. A node holds the handle of its manager and up to
+// INLINE_REPORTS direct report handles inline; only employees with more direct reports
+// spill their list into a separate vector. An Employee takes its own heap block plus one
+// more for its vector of 8-byte pointers, while a node takes 24 bytes and its employee ID
+// 4 more in a parallel array, which is scanned when searching for an ID.
+//
+// Employees can be added, but not removed. Handles stay valid as the chart grows.
+// The queries give the same results as the Orgtree queries on the same chart.
+class CompactOrgtree {
+
+public:
+    // Handle of a missing employee, and the manager of the head
+    static const int NO_INDEX = -1;
+
+    // Direct reports stored inside a node before its list spills out
+    static const int INLINE_REPORTS = 4;
+
+private:
+    struct Node {
+        int32_t manager;                    // handle of the direct manager, NO_INDEX for the head
+        int32_t numReports;
+        int32_t reports[INLINE_REPORTS];    // direct report handles, or reports[0] indexes spilled
+    };
+
+    vector<Node> nodes;                     // the pool, indexed by handle
+    vector<int32_t> ids;                    // employee ID of every node
+    vector<vector<int32_t> > spilled;       // direct reports of nodes with more than INLINE_REPORTS
+
+    int newNode(int e_id, int manager);
+    const int32_t* reportsOf(int index) const;
+    int depthOf(int index) const;
+
+public:
+    // Create an empty chart
+    CompactOrgtree();
+
+    /**
+     * Copy the organization chart under head, numbering the employees in pre-order.
+     * The Employee tree is only read, and it can be deleted once the copy is made.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit CompactOrgtree(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    // Bytes used by the nodes, the IDs and the spilled direct report lists
+    size_t getBytes() const;
+
+    // Handle of the head, NO_INDEX for an empty chart
+    int getHead() const;
+
+    /**
+     * Add the head of an empty chart.
+     *
+     * @param  e_id id of the head
+     * @return      handle of the head, NO_INDEX if the chart is not empty
+     */
+    int addHead(int e_id);
+
+    /**
+     * Add a direct report to an employee.
+     * Assume employee ID argument is unique among all employee IDs.
+     *
+     * @param  manager handle of the manager
+     * @param  e_id    id of the new employee
+     * @return         handle of the new employee
+     */
+    int addDirectReport(int manager, int e_id);
+
+    // Accessors by handle, 0 <= index < size(). O(1)
+    int getEmployeeID(int index) const;
+    int getManager(int index) const;
+    int getNumDirectReports(int index) const;
+    int getDirectReport(int index, int i) const;
+
+    // Handle of employee e_id, NO_INDEX if e_id is not present. O(N), a scan of the IDs
+    int indexOf(int e_id) const;
+
+    /**
+     * Rebuild the chart as Employee nodes, with the direct reports in the same order.
+     * The caller owns the new tree, and deletes it with Orgtree::deleteOrgtree.
+     *
+     * @return the head of the copy, nullptr for an empty chart
+     */
+    Employee* buildOrgtree() const;
+
+    // Same results as the Orgtree queries, found by scanning the IDs and following the
+    // manager handles up: O(N + level)
+    bool isEmployeePresentInOrg(int e_id) const;
+    bool findManagersOfEmployee(int e_id, vector<int> &managers) const;
+    int findEmployeeLevel(int e_id, int headLevel) const;
+    int findClosestSharedManager(int e1_id, int e2_id) const;
+    int findNumOfManagersBetween(int e1_id, int e2_id) const;
+
+    /**
+     * Count the employees under an employee, walking its subtree depth-first.
+     *
+     * @param  e_id the employee id being searched
+     * @return      number of employees under e, not counting e,
+     *              Employee::NOT_FOUND if e_id is not present
+     */
+    int findNumOfEmployeesUnder(int e_id) const;
+
+};
+
+#endif
@@ -0,0 +1,153 @@
+#include "concurrentorgtree.h"
+
+#include <functional>   // hash
+#include <thread>       // this_thread
+
+const int ConcurrentOrgtree::MAX_READERS;
+
+/**
+ * Copy the organization chart under head, walking it with an explicit stack.
+ */
+ConcurrentOrgtree::ConcurrentOrgtree(Employee* head)
+    : epoch(1), head(nullptr), index(nullptr), changed(false) {
+
+    for (int i = 0; i < MAX_READERS; i++) {
+        readers[i].epoch.store(0);
+    }
+
+    // Each stack entry is an employee of the original chart and its copy
+    vector<pair<Employee*, Employee*> > toCopy;
+    if (head != nullptr) {
+        this->head = new Employee(head->getEmployeeID());
+        this->head->setAttribute(head->getAttribute());
+        toCopy.push_back(make_pair(head, this->head));
+    }
+    while (!toCopy.empty()) {
+        Employee* original = toCopy.back().first;
+        Employee* copy = toCopy.back().second;
+        toCopy.pop_back();
+
+        const vector<Employee*> &directReports = original->getDirectReports();
+        for (size_t i = 0; i < directReports.size(); i++) {
+            copy->addDirectReport(directReports[i]->getEmployeeID());
+        }
+        const vector<Employee*> &copiedReports = copy->getDirectReports();
+        for (size_t i = 0; i < directReports.size(); i++) {
+            copiedReports[i]->setAttribute(directReports[i]->getAttribute());
+            toCopy.push_back(make_pair(directReports[i], copiedReports[i]));
+        }
+    }
+
+    index = new EmployeeIndex(this->head);
+    current.store(new Version(this->head, 0));
+}
+
+ConcurrentOrgtree::~ConcurrentOrgtree() {
+    for (size_t i = 0; i < retired.size(); i++) {
+        delete retired[i];
+    }
+    delete current.load();
+    delete index;
+    Orgtree::deleteOrgtree(head, nullptr);
+}
+
+/**
+ * Open a snapshot: claim a free reader slot with the current epoch, then read the current version.
+ *
+ * <p>
+ * The slot is claimed before the version is read, so a writer that replaces this version
+ * afterwards finds the slot and keeps the version. A writer that scanned the slot before it
+ * was claimed had already swapped in its new version, which is then the one read here.
+ */
+ConcurrentOrgtree::Snapshot::Snapshot(const ConcurrentOrgtree &org) : owner(&org), slot(0), version(nullptr) {
+    // Threads start looking at different slots, so they rarely compete for the same one
+    size_t first = hash<thread::id>()(this_thread::get_id());
+    for (int attempt = 0; ; attempt++) {
+        uint64_t free = 0;
+        uint64_t now = org.epoch.load();
+        slot = (int)((first + attempt) % MAX_READERS);
+        if (org.readers[slot].epoch.compare_exchange_strong(free, now)) {
+            break;
+        }
+        if (attempt % MAX_READERS == MAX_READERS - 1) {
+            this_thread::yield();
+        }
+    }
+    version = org.current.load();
+}
+
+// Free the reader slot, the writer can then delete the version if it was replaced
+ConcurrentOrgtree::Snapshot::~Snapshot() {
+    owner->readers[slot].epoch.store(0);
+}
+
+/**
+ * Add a direct report in the writer's copy of the chart.
+ *
+ * @param  m_id id of the manager
+ * @param  e_id id of the new employee
+ * @return      true if the employee was added,
+ *              false if m_id is not present or e_id is already present
+ */
+bool ConcurrentOrgtree::addDirectReport(int m_id, int e_id) {
+    lock_guard<mutex> guard(writeLock);
+    Employee* manager = index->findEmployee(m_id);
+    if (manager == nullptr || index->isEmployeePresentInOrg(e_id)) {
+        return false;
+    }
+    manager->addDirectReport(e_id);
+    changed = true;
+    return true;
+}
+
+/**
+ * Publish the writer's copy of the chart as a new version.
+ *
+ * <p>
+ * The new version is swapped in before the epoch advances, so every snapshot that announces
+ * the new epoch reads the new version, and the old one is only held by snapshots that
+ * announced an epoch up to the one it was retired in.
+ *
+ * @return the number of the current version
+ */
+uint64_t ConcurrentOrgtree::publish() {
+    lock_guard<mutex> guard(writeLock);
+    if (changed) {
+        Version* previous = current.load();
+        current.store(new Version(head, previous->number + 1));
+        previous->retiredEpoch = epoch.fetch_add(1);
+        retired.push_back(previous);
+        changed = false;
+    }
+    reclaim();
+    return current.load()->number;
+}
+
+/**
+ * Delete the retired versions that are older than every open snapshot.
+ * Called with the write lock held.
+ */
+void ConcurrentOrgtree::reclaim() {
+    uint64_t oldestReader = UINT64_MAX;
+    for (int i = 0; i < MAX_READERS; i++) {
+        uint64_t readerEpoch = readers[i].epoch.load();
+        if (readerEpoch != 0 && readerEpoch < oldestReader) {
+            oldestReader = readerEpoch;
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        if (retired[i]->retiredEpoch < oldestReader) {
+            delete retired[i];
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+}
+
+int ConcurrentOrgtree::getNumRetiredVersions() {
+    lock_guard<mutex> guard(writeLock);
+    return (int)retired.size();
+}
@@ -0,0 +1,134 @@
+#ifndef CONCURRENTORGTREE_H
+#define CONCURRENTORGTREE_H
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include "orgtree.h"
+#include "employeeindex.h"
+#include "flatorgtree.h"
+
+using namespace std;
+
+// An organization chart that query threads read without locks while a writer edits it.
+//
+// Readers never see the Employee tree. Every published version of the chart is an immutable
+// FlatOrgtree, and a reader opens a Snapshot that pins the current version for as long as it
+// lives, so all its queries see the same chart no matter what the writer does meanwhile.
+//
+// The writer edits a private copy of the chart, and publish() flattens it into a new version
+// and swaps it in with one atomic store. Old versions are reclaimed with epochs: opening a
+// snapshot announces the current epoch in a reader slot, every publish advances the epoch,
+// and a version retired in epoch e is deleted once no reader slot holds an epoch <= e.
+// Readers take no locks; opening a snapshot only waits when MAX_READERS snapshots are
+// already open.
+//
+// Writes (addDirectReport, publish) are serialized with a mutex and can come from any thread.
+// Every snapshot must be closed before the ConcurrentOrgtree is destroyed.
+class ConcurrentOrgtree {
+
+public:
+    // Number of snapshots that can be open at the same time without waiting
+    static const int MAX_READERS = 64;
+
+private:
+    // A published chart, tagged with the epoch in which it was replaced
+    struct Version {
+        FlatOrgtree org;
+        uint64_t number;
+        uint64_t retiredEpoch;
+
+        Version(Employee* head, uint64_t number) : org(head), number(number), retiredEpoch(0) {}
+    };
+
+    // Epoch announced by an open snapshot, 0 for a free slot, padded so readers do not share cache lines
+    struct ReaderSlot {
+        atomic<uint64_t> epoch;
+        char padding[64];
+    };
+
+    atomic<Version*> current;
+    atomic<uint64_t> epoch;
+    mutable ReaderSlot readers[MAX_READERS];    // claimed and freed by snapshots of a const chart
+
+    mutex writeLock;
+    Employee* head;                 // the writer's copy of the chart
+    EmployeeIndex* index;           // finds the managers of new direct reports in the writer's copy
+    vector<Version*> retired;       // replaced versions that readers may still use
+    bool changed;                   // the writer's copy has edits not published yet
+
+    void reclaim();
+
+public:
+    // A consistent, read-only view of the chart as of the version published when it was opened.
+    // Not copyable, and used by the thread that opened it.
+    class Snapshot {
+
+    private:
+        const ConcurrentOrgtree* owner;
+        int slot;
+        const Version* version;
+
+    public:
+        explicit Snapshot(const ConcurrentOrgtree &org);
+        ~Snapshot();
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        // The chart of this version, answering every Orgtree query by employee ID
+        const FlatOrgtree& operator*() const {
+            return version->org;
+        }
+
+        const FlatOrgtree* operator->() const {
+            return &version->org;
+        }
+
+        // Number of the version, 0 for the chart the ConcurrentOrgtree was created with
+        uint64_t getVersion() const {
+            return version->number;
+        }
+    };
+
+    /**
+     * Copy the organization chart under head and publish it as version 0.
+     * The caller keeps ownership of head.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit ConcurrentOrgtree(Employee* head);
+
+    // Deletes every version and the writer's copy of the chart
+    ~ConcurrentOrgtree();
+
+    ConcurrentOrgtree(const ConcurrentOrgtree&) = delete;
+    ConcurrentOrgtree& operator=(const ConcurrentOrgtree&) = delete;
+
+    /**
+     * Add a direct report to employee m in the writer's copy of the chart.
+     * Readers see it once publish() is called.
+     *
+     * @param  m_id id of the manager
+     * @param  e_id id of the new employee
+     * @return      true if the employee was added,
+     *              false if m_id is not present or e_id is already present
+     */
+    bool addDirectReport(int m_id, int e_id);
+
+    /**
+     * Make all edits since the last publish visible to snapshots opened from now on,
+     * and delete the versions no open snapshot uses anymore. O(N) when there are edits.
+     *
+     * @return the number of the current version
+     */
+    uint64_t publish();
+
+    // Number of replaced versions not deleted yet because snapshots may still use them
+    int getNumRetiredVersions();
+
+};
+
+#endif
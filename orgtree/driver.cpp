@@ -1,8 +1,35 @@
 #include "orgtree.h"
+#include "flatorgtree.h"
+#include "employeeindex.h"
+#include "orglcaindex.h"
+#include "orglevelindex.h"
+#include "orgpathindex.h"
+#include "orgbatchquery.h"
+#include "parallelorgtree.h"
+#include "dynamicorgtree.h"
+#include "orgloader.h"
+#include "orgsnapshot.h"
+#include "succinctorgtree.h"
+#include "employeearena.h"
+#include "concurrentorgtree.h"
+#include "orgquerycache.h"
+#include "orgmerkletree.h"
+#include "compactorgtree.h"
+#include "orgtraversal.h"
+#include "orgwriter.h"
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 using namespace std;
 
@@ -24,6 +51,1027 @@ void asserts(bool didPass, string message) {
     }
 }
 
+/**
+ * Check that a FlatOrgtree answers every query exactly like Orgtree does on the original tree
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testFlatOrgtree(Employee* head, const vector<int> &ids, string name) {
+    FlatOrgtree flat(head);
+    bool allMatch = true;
+
+    for (int e1 : ids) {
+        vector<int> managers, flatManagers;
+        allMatch = allMatch &&
+            flat.isEmployeePresentInOrg(e1) == Orgtree::isEmployeePresentInOrg(head, e1) &&
+            flat.findManagersOfEmployee(e1, flatManagers) == Orgtree::findManagersOfEmployee(head, e1, managers) &&
+            flatManagers == managers &&
+            flat.findEmployeeLevel(e1, 2) == Orgtree::findEmployeeLevel(head, e1, 2);
+
+        for (int e2 : ids) {
+            Employee* shared = Orgtree::findClosestSharedManager(head, e1, e2);
+            int sharedID = (shared == nullptr) ? Employee::NOT_FOUND : shared->getEmployeeID();
+            allMatch = allMatch &&
+                flat.findClosestSharedManager(e1, e2) == sharedID &&
+                flat.findNumOfManagersBetween(e1, e2) == Orgtree::findNumOfManagersBetween(head, e1, e2);
+        }
+    }
+    asserts(allMatch, "FlatOrgtree queries match Orgtree on " + name);
+
+    // Everyone under m is whoever has m among their managers, ids must list the whole chart
+    bool subtreesMatch = true;
+    for (int m : ids) {
+        vector<int> expectedUnder, under;
+        for (int e : ids) {
+            vector<int> managers;
+            bool isManager = Orgtree::findManagersOfEmployee(head, e, managers) &&
+                             find(managers.begin(), managers.end(), m) != managers.end();
+            if (isManager) {
+                expectedUnder.push_back(e);
+            }
+            subtreesMatch = subtreesMatch && flat.isManagerOf(m, e) == isManager;
+        }
+
+        bool found = flat.findEmployeesUnder(m, under);
+        sort(under.begin(), under.end());
+        sort(expectedUnder.begin(), expectedUnder.end());
+        subtreesMatch = subtreesMatch && found == Orgtree::isEmployeePresentInOrg(head, m) && under == expectedUnder &&
+                        flat.findNumOfEmployeesUnder(m) == (found ? (int)under.size() : Employee::NOT_FOUND);
+    }
+    asserts(subtreesMatch, "FlatOrgtree subtree intervals match the managers found by Orgtree on " + name);
+
+    // The chain view and the k-th manager walk the same managers that Orgtree finds
+    bool chainsMatch = true;
+    for (int e : ids) {
+        vector<int> managers;
+        Orgtree::findManagersOfEmployee(head, e, managers);
+        FlatOrgtree::ManagerChain chain = flat.getManagerChain(e);
+        chainsMatch = chainsMatch && vector<int>(chain.begin(), chain.end()) == managers &&
+                      chain.empty() == managers.empty() &&
+                      flat.findKthManager(e, 0) == Employee::NOT_FOUND;
+        for (int k = 1; k <= (int)managers.size() + 1; k++) {
+            int expected = (k <= (int)managers.size()) ? managers[k - 1] : Employee::NOT_FOUND;
+            chainsMatch = chainsMatch && flat.findKthManager(e, k) == expected;
+        }
+    }
+    asserts(chainsMatch, "FlatOrgtree manager chains and k-th managers match Orgtree on " + name);
+}
+
+/**
+ * Check that an EmployeeIndex answers like Orgtree, including after direct reports are added
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testEmployeeIndex(Employee* head, const vector<int> &ids, string name) {
+    EmployeeIndex index(head);
+    bool allMatch = true;
+
+    for (int e_id : ids) {
+        vector<int> managers, indexManagers;
+        allMatch = allMatch &&
+            index.isEmployeePresentInOrg(e_id) == Orgtree::isEmployeePresentInOrg(head, e_id) &&
+            index.findManagersOfEmployee(e_id, indexManagers) == Orgtree::findManagersOfEmployee(head, e_id, managers) &&
+            indexManagers == managers;
+    }
+    asserts(allMatch, "EmployeeIndex queries match Orgtree on " + name);
+}
+
+/**
+ * Check that an OrgLcaIndex answers every pair query exactly like Orgtree does
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testOrgLcaIndex(Employee* head, const vector<int> &ids, string name) {
+    OrgLcaIndex lcaIndex(head);
+    bool allMatch = true;
+
+    for (int e1 : ids) {
+        for (int e2 : ids) {
+            allMatch = allMatch &&
+                lcaIndex.findClosestSharedManager(e1, e2) == Orgtree::findClosestSharedManager(head, e1, e2) &&
+                lcaIndex.findNumOfManagersBetween(e1, e2) == Orgtree::findNumOfManagersBetween(head, e1, e2);
+        }
+    }
+    asserts(allMatch, "OrgLcaIndex queries match Orgtree on " + name);
+}
+
+/**
+ * Check that an OrgQueryCache answers like Orgtree, and from the cache the second time
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testOrgQueryCache(Employee* head, const vector<int> &ids, string name) {
+    OrgQueryCache cache(head);
+    bool allMatch = true;
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int e1 : ids) {
+            vector<int> managers, cachedManagers;
+            bool found = Orgtree::findManagersOfEmployee(head, e1, managers);
+            allMatch = allMatch && cache.findManagersOfEmployee(e1, cachedManagers) == found &&
+                       cachedManagers == managers;
+            for (int e2 : ids) {
+                allMatch = allMatch &&
+                    cache.findClosestSharedManager(e1, e2) == Orgtree::findClosestSharedManager(head, e1, e2) &&
+                    cache.findNumOfManagersBetween(e1, e2) == Orgtree::findNumOfManagersBetween(head, e1, e2);
+            }
+        }
+    }
+    asserts(allMatch, "OrgQueryCache queries match Orgtree on " + name);
+
+    // Every (e1, e2) pair shares its entry with (e2, e1), so only the first pass of each pair misses
+    unsigned long long numQueries = 2 * (ids.size() + 2 * ids.size() * ids.size());
+    unsigned long long numMisses = ids.size() + ids.size() * (ids.size() + 1);
+    asserts(cache.getNumMisses() == numMisses && cache.getNumHits() == numQueries - numMisses &&
+            cache.getNumEvictions() == 0 && cache.size() == numMisses,
+            "OrgQueryCache answers repeated queries on " + name + " from the cache");
+}
+
+/**
+ * Check that an OrgLevelIndex lays out the expected levels and finds levels like Orgtree
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param expectedLevels - Employee IDs of every level, in the order of the chart
+ * @param name - Name of the chart, for the test messages
+ */
+void testOrgLevelIndex(Employee* head, const vector<int> &ids, const vector<vector<int> > &expectedLevels,
+                       string name) {
+    OrgLevelIndex levelIndex(head);
+    vector<int> expectedHeadcounts;
+    bool sameLevels = levelIndex.getNumLevels() == (int)expectedLevels.size();
+    for (size_t level = 0; sameLevels && level < expectedLevels.size(); level++) {
+        expectedHeadcounts.push_back((int)expectedLevels[level].size());
+        sameLevels = levelIndex.getLevelSize((int)level) == (int)expectedLevels[level].size() &&
+                     vector<int>(levelIndex.levelIDsBegin((int)level), levelIndex.levelIDsEnd((int)level)) ==
+                     expectedLevels[level];
+    }
+    asserts(sameLevels && levelIndex.getLevelSize(-1) == 0 &&
+            levelIndex.getLevelSize((int)expectedLevels.size()) == 0,
+            "OrgLevelIndex lists the employees of every level of " + name);
+    asserts(levelIndex.findLevelHeadcounts() == expectedHeadcounts &&
+            OrgLevelIndex::countEmployeesPerLevel(head) == expectedHeadcounts,
+            "OrgLevelIndex counts the employees at every level of " + name);
+
+    bool allMatch = true;
+    for (int e_id : ids) {
+        allMatch = allMatch && levelIndex.findEmployeeLevel(e_id, 3) == Orgtree::findEmployeeLevel(head, e_id, 3);
+    }
+    asserts(allMatch, "OrgLevelIndex::findEmployeeLevel matches Orgtree on " + name);
+}
+
+/**
+ * Attribute given to every employee by testOrgPathIndex, mixing positive and negative values
+ * @param e_id - The employee ID
+ * @return the attribute of the employee
+ */
+long long testAttribute(int e_id) {
+    return (long long)((e_id * 37) % 101 - 50) * 1000000000LL;
+}
+
+/**
+ * Check that an OrgPathIndex aggregates the same employees that Orgtree finds on the path
+ * between every pair of ids, before and after updating an attribute
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testOrgPathIndex(Employee* head, const vector<int> &ids, string name) {
+    vector<Employee*> toVisit;
+    if (head != nullptr) {
+        toVisit.push_back(head);
+    }
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back();
+        toVisit.pop_back();
+        employee->setAttribute(testAttribute(employee->getEmployeeID()));
+        const vector<Employee*> &reports = employee->getDirectReports();
+        toVisit.insert(toVisit.end(), reports.begin(), reports.end());
+    }
+
+    OrgPathIndex pathIndex(head);
+    int updatedID = ids.empty() ? Employee::NOT_FOUND : ids[ids.size() / 2];
+    for (int round = 0; round < 2; round++) {
+        bool allMatch = true;
+        for (int e1 : ids) {
+            for (int e2 : ids) {
+                Employee* shared = Orgtree::findClosestSharedManager(head, e1, e2);
+                int sharedID = (shared == nullptr) ? Employee::NOT_FOUND : shared->getEmployeeID();
+                allMatch = allMatch && pathIndex.findClosestSharedManager(e1, e2) == sharedID;
+
+                // The path is e1 and its managers up to the shared one, then e2 and its managers below it
+                vector<int> path, managers1, managers2;
+                bool bothPresent = Orgtree::findManagersOfEmployee(head, e1, managers1) &&
+                                   Orgtree::findManagersOfEmployee(head, e2, managers2);
+                if (bothPresent) {
+                    managers1.insert(managers1.begin(), e1);
+                    managers2.insert(managers2.begin(), e2);
+                    path.assign(managers1.begin(), find(managers1.begin(), managers1.end(), sharedID) + 1);
+                    path.insert(path.end(), managers2.begin(), find(managers2.begin(), managers2.end(), sharedID));
+                }
+                long long sum = 0, minValue = 0, maxValue = 0;
+                for (size_t i = 0; i < path.size(); i++) {
+                    long long value = (path[i] == updatedID && round == 1) ? -7 : testAttribute(path[i]);
+                    sum += value;
+                    minValue = (i == 0 || value < minValue) ? value : minValue;
+                    maxValue = (i == 0 || value > maxValue) ? value : maxValue;
+                }
+
+                OrgPathIndex::PathAggregate aggregate = { 0, 0, 0, 0 };
+                bool found = pathIndex.findPathAggregate(e1, e2, aggregate);
+                allMatch = allMatch && found == bothPresent &&
+                           (!found || (aggregate.count == (int)path.size() && aggregate.sum == sum &&
+                                       aggregate.min == minValue && aggregate.max == maxValue));
+            }
+        }
+        asserts(allMatch, "OrgPathIndex path aggregates match the Orgtree paths on " + name +
+                          (round == 0 ? "" : " after an update"));
+
+        long long value = 0;
+        bool present = Orgtree::isEmployeePresentInOrg(head, updatedID);
+        asserts(pathIndex.setAttribute(updatedID, -7) == present &&
+                pathIndex.getAttribute(updatedID, value) == present && (!present || value == -7),
+                "OrgPathIndex updates the attribute of employees present in " + name);
+    }
+}
+
+/**
+ * Check that a batch of every pair of ids gets the same answers as Orgtree, in input order
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to pair up, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testOrgBatchQuery(Employee* head, const vector<int> &ids, string name) {
+    vector<pair<int, int> > pairs;
+    for (int e1 : ids) {
+        for (int e2 : ids) {
+            pairs.push_back(make_pair(e1, e2));
+        }
+    }
+
+    vector<int> numManagers = OrgBatchQuery::findNumOfManagersBetween(head, pairs, 3);
+    bool allMatch = numManagers.size() == pairs.size();
+    for (size_t q = 0; allMatch && q < pairs.size(); q++) {
+        allMatch = numManagers[q] == Orgtree::findNumOfManagersBetween(head, pairs[q].first, pairs[q].second);
+    }
+    asserts(allMatch, "OrgBatchQuery results match Orgtree on " + name);
+}
+
+/**
+ * Check that ParallelOrgtree answers every query exactly like Orgtree does, splitting work after every employee
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param numEmployees - Number of employees in the chart
+ * @param name - Name of the chart, for the test messages
+ */
+void testParallelOrgtree(Employee* head, const vector<int> &ids, int numEmployees, string name) {
+    ParallelOrgtree parallel(4, 1);
+    bool allMatch = true;
+    for (int e1 : ids) {
+        vector<int> managers, parallelManagers;
+        allMatch = allMatch &&
+                   parallel.isEmployeePresentInOrg(head, e1) == Orgtree::isEmployeePresentInOrg(head, e1) &&
+                   parallel.findEmployeeLevel(head, e1, 3) == Orgtree::findEmployeeLevel(head, e1, 3) &&
+                   parallel.findManagersOfEmployee(head, e1, parallelManagers) ==
+                   Orgtree::findManagersOfEmployee(head, e1, managers) &&
+                   parallelManagers == managers;
+        for (int e2 : ids) {
+            allMatch = allMatch &&
+                       parallel.findClosestSharedManager(head, e1, e2) == Orgtree::findClosestSharedManager(head, e1, e2) &&
+                       parallel.findNumOfManagersBetween(head, e1, e2) == Orgtree::findNumOfManagersBetween(head, e1, e2);
+        }
+    }
+    asserts(allMatch, "ParallelOrgtree searches match Orgtree on " + name);
+
+    int deepestLevel = parallel.reduce(head, 0, 0, [](Employee* employee, int level) { return level; },
+                                       [](int a, int b) { return max(a, b); });
+    int expectedDeepest = 0;
+    for (int e : ids) {
+        expectedDeepest = max(expectedDeepest, Orgtree::findEmployeeLevel(head, e, 0));
+    }
+    asserts(parallel.countEmployees(head) == numEmployees && deepestLevel == expectedDeepest,
+            "ParallelOrgtree counts " + to_string(numEmployees) + " employees and the deepest level on " + name);
+}
+
+/**
+ * Check that every Orgtree function handles a chain far deeper than the call stack allows for recursion,
+ * and that deleteOrgtree still deletes it in post order, from the bottom of the chain up to the head
+ * @param depth - Number of employees in the chain, employee i is the only direct report of employee i - 1
+ */
+void testDeepChain(int depth) {
+    Employee* head = new Employee(0);
+    Employee* bottom = head;
+    for (int i = 1; i < depth; i++) {
+        bottom->addDirectReport(i);
+        bottom = bottom->getDirectReports().back();
+    }
+    string name = "a chain of " + to_string(depth) + " employees";
+
+    asserts(Orgtree::isEmployeePresentInOrg(head, depth - 1) && !Orgtree::isEmployeePresentInOrg(head, -2),
+            "isEmployeePresentInOrg searches " + name);
+    asserts(Orgtree::findEmployeeLevel(head, depth - 1, 0) == depth - 1,
+            "findEmployeeLevel searches " + name);
+
+    vector<int> managers;
+    asserts(Orgtree::findManagersOfEmployee(head, depth - 1, managers) && (int)managers.size() == depth - 1 &&
+            managers.front() == depth - 2 && managers.back() == 0,
+            "findManagersOfEmployee searches " + name);
+
+    Employee* sharedManager = Orgtree::findClosestSharedManager(head, depth - 1, depth / 2);
+    asserts(sharedManager != nullptr && sharedManager->getEmployeeID() == depth / 2,
+            "findClosestSharedManager searches " + name);
+    asserts(Orgtree::findNumOfManagersBetween(head, 0, depth - 1) == depth - 2,
+            "findNumOfManagersBetween searches " + name);
+
+    ParallelOrgtree parallel(4, 64);
+    asserts(parallel.countEmployees(head) == depth && parallel.findEmployeeLevel(head, depth - 1, 0) == depth - 1,
+            "ParallelOrgtree searches " + name);
+
+    OrgLevelIndex levelIndex(head);
+    asserts(levelIndex.getNumLevels() == depth && levelIndex.findEmployeeLevel(depth - 1, 0) == depth - 1,
+            "OrgLevelIndex indexes " + name);
+
+    OrgPathIndex pathIndex(head);
+    OrgPathIndex::PathAggregate aggregate = { 0, 0, 0, 0 };
+    asserts(pathIndex.findPathAggregate(depth - 1, depth / 2, aggregate) && aggregate.count == depth - depth / 2 &&
+            pathIndex.findClosestSharedManager(depth - 1, depth / 2) == depth / 2,
+            "OrgPathIndex indexes " + name);
+
+    SuccinctOrgtree succinct(head);
+    asserts(succinct.findEmployeeLevel(depth - 1, 0) == depth - 1 && succinct.isManagerOf(0, depth - 1) &&
+            succinct.findClosestSharedManager(depth - 1, depth / 2) == depth / 2 &&
+            succinct.findNumOfEmployeesUnder(depth / 2) == depth - depth / 2 - 1,
+            "SuccinctOrgtree encodes " + name);
+
+    int numVisited = 0, maxLevel = 0;
+    OrgTraversal::postOrder(head, [&](Employee*, int level) {
+        numVisited++;
+        maxLevel = max(maxLevel, level);
+        return CONTINUE;
+    });
+    asserts(numVisited == depth && maxLevel == depth - 1, "OrgTraversal::postOrder walks " + name);
+
+    // Capture the deletion trace instead of printing it
+    ostringstream trace;
+    streambuf* coutBuffer = cout.rdbuf(trace.rdbuf());
+    Orgtree::deleteOrgtree(head);
+    cout.rdbuf(coutBuffer);
+
+    string lines = trace.str();
+    size_t numLines = 0;
+    for (char c : lines) {
+        numLines += (c == '\n');
+    }
+    string firstLine = "Deleting employee with ID: " + to_string(depth - 1) + "\n";
+    string lastLine = "Deleting employee with ID: 0\n";
+    asserts((int)numLines == depth && lines.compare(0, firstLine.size(), firstLine) == 0 &&
+            lines.compare(lines.size() - lastLine.size(), lastLine.size(), lastLine) == 0,
+            "deleteOrgtree deletes " + name + " from the bottom up");
+}
+
+/**
+ * Delete a chart with deleteOrgtree, discarding its deletion trace
+ * @param head - The head of the organization chart
+ */
+void deleteWithoutTrace(Employee* head) {
+    Orgtree::deleteOrgtree(head, nullptr);
+}
+
+/**
+ * Check that a DynamicOrgtree answers every query like Orgtree does on a copy of its current chart
+ * @param dynamic - The dynamic chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @return whether every query matched
+ */
+bool dynamicMatchesOrgtree(DynamicOrgtree &dynamic, const vector<int> &ids) {
+    Employee* copy = dynamic.buildOrgtree();
+    bool allMatch = (copy == nullptr ? Employee::EMPTY_EMPLOYEEID : copy->getEmployeeID()) == dynamic.getHeadID();
+
+    for (int e1 : ids) {
+        vector<int> managers;
+        bool found = Orgtree::findManagersOfEmployee(copy, e1, managers);
+        allMatch = allMatch &&
+                   dynamic.isEmployeePresentInOrg(e1) == found &&
+                   dynamic.getManagerID(e1) == (managers.empty() ? Employee::NOT_FOUND : managers.front()) &&
+                   dynamic.findEmployeeLevel(e1, 1) == Orgtree::findEmployeeLevel(copy, e1, 1);
+
+        for (int e2 : ids) {
+            Employee* shared = Orgtree::findClosestSharedManager(copy, e1, e2);
+            int sharedID = (shared == nullptr) ? Employee::NOT_FOUND : shared->getEmployeeID();
+            vector<int> e2_managers;
+            Orgtree::findManagersOfEmployee(copy, e2, e2_managers);
+            bool isManager = find(e2_managers.begin(), e2_managers.end(), e1) != e2_managers.end();
+            allMatch = allMatch &&
+                       dynamic.findClosestSharedManager(e1, e2) == sharedID &&
+                       dynamic.findNumOfManagersBetween(e1, e2) == Orgtree::findNumOfManagersBetween(copy, e1, e2) &&
+                       dynamic.isManagerOf(e1, e2) == isManager;
+        }
+    }
+    deleteWithoutTrace(copy);
+    return allMatch;
+}
+
+/**
+ * Check DynamicOrgtree reorgs on chart 2, and on a random sequence of reorgs
+ * @param head - The head of chart 2
+ * @param ids - Employee IDs of chart 2, and missing ones
+ */
+void testDynamicOrgtree(Employee* head, vector<int> ids) {
+    DynamicOrgtree dynamic(head);
+    asserts(dynamic.size() == 12 && dynamicMatchesOrgtree(dynamic, ids), "DynamicOrgtree matches Orgtree on chart 2");
+
+    // Move 302 (with 303, 401 and 402 under it) under 201, then add 601 under 303
+    asserts(dynamic.moveEmployee(302, 201) && dynamic.getManagerID(302) == 201,
+            "DynamicOrgtree moves 302 and its subtree under 201");
+    asserts(dynamic.addEmployee(601, 303) && !dynamic.addEmployee(601, 100) && !dynamic.addEmployee(602, 999),
+            "DynamicOrgtree adds 601 under 303, and rejects a duplicate ID and a missing manager");
+    asserts(!dynamic.moveEmployee(201, 303) && !dynamic.moveEmployee(201, 201) && !dynamic.moveEmployee(100, 300),
+            "DynamicOrgtree rejects moving an employee under itself, its own report, or moving the head");
+    ids.push_back(601);
+    asserts(dynamic.findNumOfManagersBetween(601, 203) == 3 && dynamicMatchesOrgtree(dynamic, ids),
+            "DynamicOrgtree matches Orgtree after moving and adding employees");
+
+    // Remove 302: 303 takes its place under 201
+    asserts(dynamic.removeEmployee(302) && dynamic.getManagerID(303) == 201 && !dynamic.isEmployeePresentInOrg(302),
+            "DynamicOrgtree removes 302 and moves its direct reports up to 201");
+    asserts(!dynamic.removeEmployee(100) && dynamic.getHeadID() == 100,
+            "DynamicOrgtree keeps a head with several direct reports");
+    asserts(dynamic.removeSubtree(300) == 2 && dynamic.size() == 10 && dynamicMatchesOrgtree(dynamic, ids),
+            "DynamicOrgtree removes the subtree of 300 and matches Orgtree");
+    asserts(dynamic.removeSubtree(100) == 10 && dynamic.size() == 0 && dynamicMatchesOrgtree(dynamic, ids),
+            "DynamicOrgtree removes the whole chart");
+    asserts(dynamic.addEmployee(1, Employee::EMPTY_EMPLOYEEID) && dynamic.addEmployee(2, 1) &&
+            dynamic.removeEmployee(1) && dynamic.getHeadID() == 2,
+            "DynamicOrgtree replaces a head that has one direct report");
+
+    // A random sequence of reorgs, checked against Orgtree every 50 steps
+    const int MAX_ID = 120;
+    DynamicOrgtree randomOrg(nullptr);
+    randomOrg.addEmployee(0, Employee::EMPTY_EMPLOYEEID);
+    vector<int> randomIDs;
+    for (int e = 0; e <= MAX_ID; e++) {
+        randomIDs.push_back(e);
+    }
+    srand(2024);
+    bool allMatch = true;
+    for (int step = 1; step <= 1000 && allMatch; step++) {
+        int e1 = rand() % (MAX_ID + 1);
+        int e2 = rand() % (MAX_ID + 1);
+        int action = rand() % 10;
+        if (action < 5) {
+            randomOrg.addEmployee(e1, e2);
+        }
+        else if (action < 8) {
+            randomOrg.moveEmployee(e1, e2);
+        }
+        else if (action < 9) {
+            randomOrg.removeEmployee(e1);
+        }
+        else if (e1 != randomOrg.getHeadID()) {
+            randomOrg.removeSubtree(e1);
+        }
+        if (step % 50 == 0) {
+            allMatch = dynamicMatchesOrgtree(randomOrg, randomIDs);
+        }
+    }
+    asserts(allMatch && randomOrg.size() > 0, "DynamicOrgtree matches Orgtree through 1000 random reorgs");
+}
+
+/**
+ * Check that two charts have the same employees with the same direct reports, in the same order
+ * @param a - The head of the first chart
+ * @param b - The head of the second chart
+ * @return whether the charts are the same
+ */
+bool sameOrgtree(Employee* a, Employee* b) {
+    vector<pair<Employee*, Employee*> > toCompare(1, make_pair(a, b));
+    while (!toCompare.empty()) {
+        Employee* e1 = toCompare.back().first;
+        Employee* e2 = toCompare.back().second;
+        toCompare.pop_back();
+        if (e1 == nullptr || e2 == nullptr) {
+            if (e1 != e2) {
+                return false;
+            }
+            continue;
+        }
+        const vector<Employee*> &reports1 = e1->getDirectReports();
+        const vector<Employee*> &reports2 = e2->getDirectReports();
+        if (e1->getEmployeeID() != e2->getEmployeeID() || reports1.size() != reports2.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < reports1.size(); i++) {
+            toCompare.push_back(make_pair(reports1[i], reports2[i]));
+        }
+    }
+    return true;
+}
+
+/**
+ * Load a CSV edge file with the given contents
+ * @param contents - The contents of the file
+ * @return the loaded chart, nullptr if it failed to load
+ */
+Employee* loadCsvText(string contents) {
+    const string path = "orgloader_test.csv";
+    ofstream(path.c_str()) << contents;
+    Employee* head = OrgLoader::loadCsv(path, 3);
+    remove(path.c_str());
+    return head;
+}
+
+/**
+ * Check that OrgLoader reads back the charts it writes, in both formats, and rejects broken files
+ * @param head - The head of the organization chart to write and read back
+ */
+void testOrgLoader(Employee* head) {
+    const string csvPath = "orgloader_test.csv";
+    const string binaryPath = "orgloader_test.bin";
+
+    asserts(OrgLoader::writeEdges(head, csvPath, false) && OrgLoader::writeEdges(head, binaryPath, true),
+            "OrgLoader writes chart 2 as CSV and binary edges");
+    for (int numThreads = 1; numThreads <= 4; numThreads++) {
+        Employee* fromCsv = OrgLoader::loadCsv(csvPath, numThreads);
+        Employee* fromBinary = OrgLoader::loadBinary(binaryPath, numThreads);
+        asserts(sameOrgtree(head, fromCsv) && sameOrgtree(head, fromBinary),
+                "OrgLoader reads chart 2 back from CSV and binary edges with " + to_string(numThreads) + " threads");
+        deleteWithoutTrace(fromCsv);
+        deleteWithoutTrace(fromBinary);
+    }
+    remove(csvPath.c_str());
+    remove(binaryPath.c_str());
+
+    // Reports before their managers, a header, CRLF line ends, blanks and an empty line
+    Employee* expected = new Employee(1, vector<int>{2, 3});
+    expected->getDirectReports().at(1)->addDirectReport(4);
+    Employee* loaded = loadCsvText("employee,manager\r\n4, 3\r\n2,1\r\n\r\n1,\r\n3 ,1");
+    asserts(sameOrgtree(expected, loaded), "OrgLoader reads unordered CSV rows with a header and CRLF line ends");
+    deleteWithoutTrace(expected);
+    deleteWithoutTrace(loaded);
+
+    asserts(loadCsvText("1,-1\n2,1\n2,1\n") == nullptr, "OrgLoader rejects a duplicate employee");
+    asserts(loadCsvText("1,-1\n2,-1\n") == nullptr, "OrgLoader rejects two heads");
+    asserts(loadCsvText("2,1\n3,2\n") == nullptr, "OrgLoader rejects a chart without a head");
+    asserts(loadCsvText("1,-1\n2,9\n") == nullptr, "OrgLoader rejects an unknown manager");
+    asserts(loadCsvText("1,-1\n2,3\n3,2\n") == nullptr, "OrgLoader rejects a management cycle");
+    asserts(loadCsvText("1,-1\n2;1\n") == nullptr, "OrgLoader rejects a malformed row");
+    asserts(loadCsvText("") == nullptr && OrgLoader::loadCsv("missing.csv", 1) == nullptr,
+            "OrgLoader returns nullptr for an empty or missing file");
+}
+
+/**
+ * Check that an OrgSnapshot answers like the FlatOrgtree it was written from, and rejects damaged files
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testOrgSnapshot(Employee* head, const vector<int> &ids, string name) {
+    const string path = "orgsnapshot_test.bin";
+    FlatOrgtree flat(head);
+
+    asserts(OrgSnapshot::write(flat, path), "OrgSnapshot writes a snapshot of " + name);
+    OrgSnapshot* snapshot = OrgSnapshot::open(path, true);
+    bool allMatch = snapshot != nullptr && snapshot->size() == flat.size();
+    for (size_t i = 0; allMatch && i < ids.size(); i++) {
+        int e1 = ids[i];
+        vector<int> managers, snapshotManagers;
+        allMatch = snapshot->indexOf(e1) == flat.indexOf(e1) &&
+                   snapshot->findManagersOfEmployee(e1, snapshotManagers) == flat.findManagersOfEmployee(e1, managers) &&
+                   snapshotManagers == managers &&
+                   snapshot->findEmployeeLevel(e1, 2) == flat.findEmployeeLevel(e1, 2) &&
+                   snapshot->findNumOfEmployeesUnder(e1) == flat.findNumOfEmployeesUnder(e1);
+        for (int e2 : ids) {
+            allMatch = allMatch &&
+                       snapshot->findClosestSharedManager(e1, e2) == flat.findClosestSharedManager(e1, e2) &&
+                       snapshot->findNumOfManagersBetween(e1, e2) == flat.findNumOfManagersBetween(e1, e2) &&
+                       snapshot->isManagerOf(e1, e2) == flat.isManagerOf(e1, e2);
+        }
+    }
+    asserts(allMatch, "OrgSnapshot queries match FlatOrgtree on " + name);
+    delete snapshot;
+
+    // Flip one byte of the last slot, then cut the file short
+    string contents;
+    {
+        ifstream file(path.c_str(), ios::binary);
+        contents.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    string corrupted = contents;
+    corrupted[corrupted.size() - 1] ^= 0x40;
+    ofstream(path.c_str(), ios::binary) << corrupted;
+    snapshot = OrgSnapshot::open(path, false);
+    asserts(OrgSnapshot::open(path, true) == nullptr && snapshot != nullptr,
+            "OrgSnapshot rejects a corrupted snapshot of " + name + " only when verifying the checksum");
+    delete snapshot;
+
+    ofstream(path.c_str(), ios::binary) << contents.substr(0, contents.size() - 4);
+    asserts(OrgSnapshot::open(path, false) == nullptr, "OrgSnapshot rejects a truncated snapshot of " + name);
+
+    string otherVersion = contents;
+    otherVersion[12] ^= 0x02;
+    ofstream(path.c_str(), ios::binary) << otherVersion;
+    asserts(OrgSnapshot::open(path, false) == nullptr, "OrgSnapshot rejects a snapshot of another version");
+
+    remove(path.c_str());
+    asserts(OrgSnapshot::open(path, false) == nullptr, "OrgSnapshot returns nullptr for a missing file");
+}
+
+/**
+ * Check that ConcurrentOrgtree snapshots keep seeing their version while a writer publishes new ones,
+ * first step by step, then with reader threads running against a writer
+ * @param head - The head of chart 2, which must not change
+ */
+void testConcurrentOrgtree(Employee* head) {
+    ConcurrentOrgtree org(head);
+    vector<int> managers;
+    {
+        ConcurrentOrgtree::Snapshot before(org);
+        asserts(before.getVersion() == 0 && before->size() == 12 && before->findClosestSharedManager(401, 204) == 200,
+                "A ConcurrentOrgtree snapshot answers queries on chart 2");
+
+        asserts(org.addDirectReport(303, 501) && !org.addDirectReport(999, 502) && !org.addDirectReport(100, 501),
+                "ConcurrentOrgtree adds direct reports only to present managers, and only new employees");
+        {
+            ConcurrentOrgtree::Snapshot unpublished(org);
+            asserts(unpublished.getVersion() == 0 && !unpublished->isEmployeePresentInOrg(501),
+                    "ConcurrentOrgtree edits are not visible before they are published");
+        }
+
+        asserts(org.publish() == 1, "ConcurrentOrgtree publishes version 1");
+        ConcurrentOrgtree::Snapshot after(org);
+        asserts(after.getVersion() == 1 && after->findManagersOfEmployee(501, managers) &&
+                managers == vector<int>({303, 302, 202, 200, 100}),
+                "A snapshot opened after publishing sees 501 under 303");
+        asserts(before.getVersion() == 0 && !before->isEmployeePresentInOrg(501) && before->size() == 12,
+                "A snapshot opened before publishing still sees version 0");
+        asserts(org.getNumRetiredVersions() == 1, "Version 0 is kept while a snapshot uses it");
+    }
+    org.publish();
+    asserts(org.getNumRetiredVersions() == 0 && !Orgtree::isEmployeePresentInOrg(head, 501),
+            "Version 0 is deleted once its snapshots are closed, and the original chart is unchanged");
+
+    // The writer grows a chain 1000, 1001, ... under 100, publishing after every employee, so
+    // version v has exactly the employees 1000 .. 999 + v of the chain, at levels 1 .. v
+    const int NUM_VERSIONS = 200;
+    const int NUM_READERS = 4;
+    atomic<bool> writerDone(false);
+    atomic<int> inconsistent(0);
+    atomic<long> reads(0);
+    vector<thread> readers;
+    for (int r = 0; r < NUM_READERS; r++) {
+        readers.push_back(thread([&]() {
+            while (!writerDone.load()) {
+                ConcurrentOrgtree::Snapshot snapshot(org);
+                int v = (int)snapshot.getVersion() - 1;
+                bool consistent = v == 0 ||
+                    (snapshot->findEmployeeLevel(999 + v, 0) == v && !snapshot->isEmployeePresentInOrg(1000 + v) &&
+                     snapshot->size() == 13 + v);
+                inconsistent += !consistent;
+                reads++;
+            }
+        }));
+    }
+    for (int v = 1; v <= NUM_VERSIONS; v++) {
+        org.addDirectReport((v == 1) ? 100 : 998 + v, 999 + v);
+        org.publish();
+    }
+    writerDone.store(true);
+    for (size_t r = 0; r < readers.size(); r++) {
+        readers[r].join();
+    }
+    org.publish();
+    asserts(inconsistent.load() == 0 && reads.load() > 0,
+            "ConcurrentOrgtree readers see consistent versions while the writer publishes " +
+            to_string(NUM_VERSIONS) + " of them");
+    asserts(org.getNumRetiredVersions() == 0, "ConcurrentOrgtree deletes every replaced version once readers are done");
+}
+
+/**
+ * Build a chart in an EmployeeArena, delete part of it, and release the rest
+ */
+void testEmployeeArena() {
+    /*
+     *          1
+     *        /   \
+     *       2     3
+     *      / \     \
+     *     4   5     6
+     *               |
+     *               7
+     */
+    EmployeeArena arena(4);
+    Employee* head = arena.newEmployee(1, vector<int>{2, 3});
+    head->getDirectReports().at(0)->addDirectReports(vector<int>{4, 5});
+    Employee* e3 = head->getDirectReports().at(1);
+    e3->addDirectReport(6);
+    e3->getDirectReports().at(0)->addDirectReport(7);
+
+    vector<int> managers;
+    asserts(arena.size() == 7, "EmployeeArena holds all 7 employees of the chart, including added direct reports");
+    asserts(Orgtree::findManagersOfEmployee(head, 7, managers) && managers == vector<int>({6, 3, 1}) &&
+            Orgtree::findClosestSharedManager(head, 5, 7) == head &&
+            Orgtree::findNumOfManagersBetween(head, 4, 7) == 4,
+            "Orgtree queries work on a chart built in an EmployeeArena");
+
+    // Deleting a second chart returns its slots to the arena, in the same order as heap employees
+    Employee* other = arena.newEmployee(10, vector<int>{11, 12});
+    other->getDirectReports().at(0)->addDirectReport(13);
+    ostringstream trace;
+    Orgtree::deleteOrgtree(other, &trace);
+    asserts(trace.str() == "Deleting employee with ID: 13\nDeleting employee with ID: 11\n"
+                           "Deleting employee with ID: 12\nDeleting employee with ID: 10\n",
+            "deleteOrgtree traces arena employees in post-order");
+    asserts(arena.size() == 7, "deleteOrgtree returns deleted employees to their EmployeeArena");
+
+    // Freed slots are reused, then release() destroys what is left without walking the chart
+    head->addDirectReport(8);
+    asserts(arena.size() == 8 && Orgtree::findEmployeeLevel(head, 8, 1) == 2,
+            "EmployeeArena reuses freed slots for new direct reports");
+    arena.release();
+    asserts(arena.size() == 0, "EmployeeArena::release destroys every employee");
+
+    // Deleting a heap chart without a trace writes nothing
+    ostringstream quiet;
+    streambuf* coutBuffer = cout.rdbuf(quiet.rdbuf());
+    Orgtree::deleteOrgtree(new Employee(1, vector<int>{2, 3}), nullptr);
+    cout.rdbuf(coutBuffer);
+    asserts(quiet.str().empty(), "deleteOrgtree with no trace stream writes nothing");
+}
+
+/**
+ * Check that a SuccinctOrgtree answers like the FlatOrgtree of the same chart
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testSuccinctOrgtree(Employee* head, const vector<int> &ids, string name) {
+    FlatOrgtree flat(head);
+    SuccinctOrgtree succinct(head);
+
+    bool sameShape = succinct.size() == flat.size();
+    for (int index = 0; sameShape && index < flat.size(); index++) {
+        vector<int> directReports;
+        int e_id = flat.getEmployeeID(index);
+        sameShape = succinct.getEmployeeID(index) == e_id && succinct.indexOf(e_id) == index &&
+                    succinct.getManagerIndex(index) == flat.getManagerIndex(index) &&
+                    succinct.getLevel(index) == flat.getLevel(index) &&
+                    succinct.findDirectReports(e_id, directReports) &&
+                    (int)directReports.size() == flat.getNumDirectReports(index);
+        for (size_t i = 0; sameShape && i < directReports.size(); i++) {
+            sameShape = directReports[i] == flat.getEmployeeID(flat.directReportsBegin(index)[i]);
+        }
+    }
+    asserts(sameShape, "SuccinctOrgtree encodes every employee, manager, level and direct report of " + name);
+
+    bool allMatch = true;
+    for (size_t i = 0; allMatch && i < ids.size(); i++) {
+        int e1 = ids[i];
+        vector<int> managers, succinctManagers;
+        allMatch = succinct.isEmployeePresentInOrg(e1) == flat.isEmployeePresentInOrg(e1) &&
+                   succinct.findManagersOfEmployee(e1, succinctManagers) == flat.findManagersOfEmployee(e1, managers) &&
+                   succinctManagers == managers &&
+                   succinct.findEmployeeLevel(e1, 2) == flat.findEmployeeLevel(e1, 2) &&
+                   succinct.findNumOfEmployeesUnder(e1) == flat.findNumOfEmployeesUnder(e1);
+        for (int e2 : ids) {
+            allMatch = allMatch &&
+                       succinct.findClosestSharedManager(e1, e2) == flat.findClosestSharedManager(e1, e2) &&
+                       succinct.findNumOfManagersBetween(e1, e2) == flat.findNumOfManagersBetween(e1, e2) &&
+                       succinct.isManagerOf(e1, e2) == flat.isManagerOf(e1, e2);
+        }
+    }
+    asserts(allMatch, "SuccinctOrgtree queries match FlatOrgtree on " + name);
+}
+
+/**
+ * Build a chart of numEmployees employees with shuffled IDs, where every employee reports to
+ * one of the few employees added just before it or, now and then, to anyone added before it,
+ * so the chart has long chains as well as wide levels
+ * @param numEmployees - Number of employees in the chart
+ * @param ids - Filled with the employee IDs, in the order they were added
+ * @return the head of the chart
+ */
+Employee* buildRandomOrg(int numEmployees, vector<int> &ids) {
+    unsigned long long state = 12345;
+    vector<Employee*> employees;
+    for (int i = 0; i < numEmployees; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int r = (int)(state >> 33);
+        ids.push_back((int)(((long long)i * 7919) % 1000003));
+        if (i == 0) {
+            employees.push_back(new Employee(ids[0]));
+            continue;
+        }
+        int manager = (r % 8 == 0) ? r % i : max(0, i - 1 - r % 4);
+        employees[manager]->addDirectReport(ids[i]);
+        employees.push_back(employees[manager]->getDirectReports().back());
+    }
+    return employees.empty() ? nullptr : employees[0];
+}
+
+/**
+ * Check that OrgMerkleTree finds the changes between two charts, and that applying them
+ * to a DynamicOrgtree of the first chart gives the second one
+ * @param before - The head of the old chart
+ * @param after - The head of the new chart
+ * @param expected - The changes from before to after
+ * @param name - Name of the change, for the test messages
+ */
+void testOrgMerkleTree(Employee* before, Employee* after, const OrgMerkleTree::Diff &expected, string name) {
+    OrgMerkleTree oldHashes(before), newHashes(after);
+    OrgMerkleTree::Diff changes;
+    OrgMerkleTree::diff(oldHashes, newHashes, changes);
+
+    auto same = [](const vector<OrgMerkleTree::Change> &a, const vector<OrgMerkleTree::Change> &b) {
+        bool equal = a.size() == b.size();
+        for (size_t i = 0; equal && i < a.size(); i++) {
+            equal = a[i].employeeID == b[i].employeeID && a[i].oldManagerID == b[i].oldManagerID &&
+                    a[i].newManagerID == b[i].newManagerID;
+        }
+        return equal;
+    };
+    asserts(same(changes.inserts, expected.inserts) && same(changes.moves, expected.moves) &&
+            same(changes.deletes, expected.deletes),
+            "OrgMerkleTree finds the inserts, moves and deletes of " + name);
+    asserts((oldHashes.getRootHash() == newHashes.getRootHash()) == expected.empty(),
+            "OrgMerkleTree root hashes differ exactly when the charts do, for " + name);
+
+    DynamicOrgtree org(before);
+    asserts(OrgMerkleTree::applyChanges(changes, org), "OrgMerkleTree applies the changes of " + name);
+    Employee* updated = org.buildOrgtree();
+    asserts(OrgMerkleTree(updated).getRootHash() == newHashes.getRootHash(),
+            "DynamicOrgtree updated with the changes of " + name + " holds the new chart");
+    deleteWithoutTrace(updated);
+}
+
+/**
+ * Check that a CompactOrgtree answers like Orgtree and copies back to the same chart
+ * @param head - The head of the organization chart
+ * @param ids - Employee IDs to query, both present and missing ones
+ * @param name - Name of the chart, for the test messages
+ */
+void testCompactOrgtree(Employee* head, const vector<int> &ids, string name) {
+    CompactOrgtree compact(head);
+    FlatOrgtree flat(head);
+    asserts(compact.size() == flat.size(), "CompactOrgtree holds every employee of " + name);
+
+    bool allMatch = true;
+    for (int e1 : ids) {
+        vector<int> managers, compactManagers;
+        bool found = Orgtree::findManagersOfEmployee(head, e1, managers);
+        allMatch = allMatch && compact.isEmployeePresentInOrg(e1) == Orgtree::isEmployeePresentInOrg(head, e1) &&
+                   compact.findManagersOfEmployee(e1, compactManagers) == found && compactManagers == managers &&
+                   compact.findEmployeeLevel(e1, 3) == Orgtree::findEmployeeLevel(head, e1, 3) &&
+                   compact.findNumOfEmployeesUnder(e1) == flat.findNumOfEmployeesUnder(e1);
+        for (int e2 : ids) {
+            Employee* shared = Orgtree::findClosestSharedManager(head, e1, e2);
+            allMatch = allMatch &&
+                compact.findClosestSharedManager(e1, e2) == (shared == nullptr ? Employee::NOT_FOUND
+                                                                                : shared->getEmployeeID()) &&
+                compact.findNumOfManagersBetween(e1, e2) == Orgtree::findNumOfManagersBetween(head, e1, e2);
+        }
+    }
+    asserts(allMatch, "CompactOrgtree queries match Orgtree on " + name);
+
+    Employee* copy = compact.buildOrgtree();
+    asserts(sameOrgtree(head, copy), "CompactOrgtree copies back to the same chart for " + name);
+    deleteWithoutTrace(copy);
+}
+
+/**
+ * Check the visiting order of the OrgTraversal functions on chart 1, and stopping or pruning them
+ * @param head - The head of chart 1
+ */
+void testOrgTraversal(Employee* head) {
+    vector<int> preIDs, postIDs, levelIDs, levels;
+    bool completed = OrgTraversal::preOrder(head, [&](Employee* employee, int level) {
+        preIDs.push_back(employee->getEmployeeID());
+        levels.push_back(level);
+        return CONTINUE;
+    });
+    asserts(completed && preIDs == vector<int>({1, 2, 5, 10, 6, 11, 3, 7, 8, 4, 9, 12}) &&
+            levels == vector<int>({0, 1, 2, 3, 2, 3, 1, 2, 2, 1, 2, 3}),
+            "OrgTraversal::preOrder visits chart 1 managers first, with their levels");
+
+    levels.clear();
+    OrgTraversal::postOrder(head, [&](Employee* employee, int level) {
+        postIDs.push_back(employee->getEmployeeID());
+        levels.push_back(level);
+        return CONTINUE;
+    });
+    asserts(postIDs == vector<int>({10, 5, 11, 6, 2, 7, 8, 3, 12, 9, 4, 1}) &&
+            levels == vector<int>({3, 2, 3, 2, 1, 2, 2, 1, 3, 2, 1, 0}),
+            "OrgTraversal::postOrder visits chart 1 direct reports first, with their levels");
+
+    OrgTraversal::levelOrder(head, [&](Employee* employee, int) {
+        levelIDs.push_back(employee->getEmployeeID());
+        return CONTINUE;
+    });
+    asserts(levelIDs == vector<int>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}),
+            "OrgTraversal::levelOrder visits chart 1 level by level");
+
+    // Stop at 7, and prune below 2
+    vector<int> stoppedIDs, prunedIDs, prunedLevelIDs;
+    completed = OrgTraversal::preOrder(head, [&](Employee* employee, int) {
+        stoppedIDs.push_back(employee->getEmployeeID());
+        return employee->getEmployeeID() == 7 ? STOP : CONTINUE;
+    });
+    asserts(!completed && stoppedIDs == vector<int>({1, 2, 5, 10, 6, 11, 3, 7}),
+            "OrgTraversal::preOrder stops right after the visitor returns STOP");
+    OrgTraversal::preOrder(head, [&](Employee* employee, int) {
+        prunedIDs.push_back(employee->getEmployeeID());
+        return employee->getEmployeeID() == 2 ? SKIP_SUBTREE : CONTINUE;
+    });
+    OrgTraversal::levelOrder(head, [&](Employee* employee, int) {
+        prunedLevelIDs.push_back(employee->getEmployeeID());
+        return employee->getEmployeeID() == 2 ? SKIP_SUBTREE : CONTINUE;
+    });
+    asserts(prunedIDs == vector<int>({1, 2, 3, 7, 8, 4, 9, 12}) &&
+            prunedLevelIDs == vector<int>({1, 2, 3, 4, 7, 8, 9, 12}),
+            "OrgTraversal skips the employees under 2 when the visitor returns SKIP_SUBTREE");
+
+    // A traversal inside a visitor gets its own stack
+    vector<int> headcounts;
+    OrgTraversal::preOrder(head, [&](Employee* employee, int level) {
+        int headcount = 0;
+        OrgTraversal::preOrder(employee, [&headcount](Employee*, int) {
+            headcount++;
+            return CONTINUE;
+        });
+        headcounts.push_back(headcount);
+        return level == 0 ? CONTINUE : SKIP_SUBTREE;
+    });
+    asserts(headcounts == vector<int>({12, 5, 3, 3}),
+            "OrgTraversal runs a traversal from inside a visitor, counting 12, 5, 3, 3 employees");
+    asserts(OrgTraversal::preOrder(nullptr, [](Employee*, int) { return STOP; }) &&
+            OrgTraversal::postOrder(nullptr, [](Employee*, int) { return STOP; }) &&
+            OrgTraversal::levelOrder(nullptr, [](Employee*, int) { return STOP; }),
+            "OrgTraversal visits nothing in the empty chart");
+}
+
+/**
+ * Check that OrgWriter formats numbers and hands its output to memory, file and stream sinks
+ */
+void testOrgWriter() {
+    string expected;
+    MemorySink memory;
+    {
+        // A tiny buffer, so the output is handed over in many blocks
+        OrgWriter writer(memory, 1);
+        const long long numbers[] = {0, 7, -1, 42, 2147483647LL, -2147483648LL,
+                                     9223372036854775807LL, -9223372036854775807LL - 1};
+        for (long long number : numbers) {
+            writer.writeInt(number);
+            writer.writeChar(' ');
+            expected += to_string(number) + " ";
+        }
+        string longText(100, 'x');
+        writer.write(longText);
+        writer.write("end", 3);
+        expected += longText + "end";
+    }
+    asserts(memory.getContents() == expected, "OrgWriter writes numbers and text through a 32 byte buffer");
+
+    const string path = "orgwriter_test.txt";
+    {
+        FileSink file(path);
+        OrgWriter writer(file);
+        writer.write(expected);
+        writer.flush();
+        asserts(writer.isGood(), "OrgWriter writes to a FileSink");
+    }
+    ifstream input(path.c_str());
+    string contents((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+    input.close();
+    remove(path.c_str());
+    asserts(contents == expected, "FileSink closes its file with everything written to it");
+
+    FileSink missing("no_such_directory/orgwriter_test.txt");
+    asserts(!missing.isGood(), "FileSink reports a file it cannot create");
+
+    ostringstream stream;
+    StreamSink streamSink(stream);
+    OrgWriter writer(streamSink);
+    writer.writeInt(-12);
+    asserts(stream.str().empty(), "OrgWriter keeps its output until its buffer is full or flushed");
+    writer.flush();
+    asserts(stream.str() == "-12" && writer.isGood(), "OrgWriter flushes its output to a StreamSink");
+
+    // A writer on the stack hands over its output when an exception unwinds it
+    MemorySink unwound;
+    try {
+        OrgWriter thrownWriter(unwound);
+        thrownWriter.write("before the exception");
+        throw 1;
+    }
+    catch (int) {
+    }
+    asserts(unwound.getContents() == "before the exception",
+            "OrgWriter flushes its output when unwound by an exception");
+}
+
 //TODO
 int main(int argc, char **argv) {
     /*
@@ -211,6 +1259,473 @@ int main(int argc, char **argv) {
     asserts(numManagers2 == 4, "Managers between 203 and 301 returns " + to_string(numManagers2) + ", expected 4");
 
 
+    // Test FlatOrgtree against the Orgtree results on both charts
+    testFlatOrgtree(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testFlatOrgtree(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                    "chart 2");
+    testFlatOrgtree(emptyHead, vector<int>{1, 2}, "the empty chart");
+    testFlatOrgtree(singleEmployee, vector<int>{1, 2}, "the single employee chart");
+
+
+    // Search a manager chain for the first manager that matches, without copying the chain
+    {
+        FlatOrgtree flat(head1);
+        FlatOrgtree::ManagerChain chain = flat.getManagerChain(401);
+        FlatOrgtree::ManagerChain::const_iterator found =
+            find_if(chain.begin(), chain.end(), [](int m_id) { return m_id < 300; });
+        asserts(found != chain.end() && *found == 202 && flat.getEmployeeID(found.getIndex()) == 202,
+                "The first manager of 401 with an ID below 300 should be 202");
+        asserts(flat.findKthManager(401, 2) == 302 && flat.findKthManager(401, 5) == 100 &&
+                flat.findKthManager(401, 6) == Employee::NOT_FOUND,
+                "The 2nd and 5th managers of 401 should be 302 and 100, and there is no 6th");
+    }
+    {
+        // A comb deep enough for findKthManager to binary search: spine employee i manages
+        // spine employee i + 1 and leaf 1000 + i
+        Employee* spineHead = new Employee(0);
+        Employee* spine = spineHead;
+        for (int i = 1; i < 30; i++) {
+            spine->addDirectReports(vector<int>{1000 + i - 1, i});
+            spine = spine->getDirectReports().back();
+        }
+        FlatOrgtree flat(spineHead);
+        bool allMatch = true;
+        for (int index = 0; index < flat.size(); index++) {
+            int e_id = flat.getEmployeeID(index);
+            FlatOrgtree::ManagerChain chain = flat.getManagerChain(e_id);
+            vector<int> managers(chain.begin(), chain.end());
+            for (int k = 1; k <= (int)managers.size(); k++) {
+                allMatch = allMatch && flat.findKthManager(e_id, k) == managers[k - 1];
+            }
+        }
+        asserts(allMatch && flat.findKthManager(29, 29) == 0 && flat.findKthManager(1020, 12) == 9,
+                "findKthManager matches the manager chain on a deep comb");
+        deleteWithoutTrace(spineHead);
+    }
+
+    // Test OrgLcaIndex against the Orgtree results on all charts
+    testOrgLcaIndex(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testOrgLcaIndex(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                    "chart 2");
+    testOrgLcaIndex(emptyHead, vector<int>{1, 2}, "the empty chart");
+    testOrgLcaIndex(singleEmployee, vector<int>{1, 2}, "the single employee chart");
+
+    // Test OrgQueryCache against the Orgtree results, then its eviction and invalidation
+    testOrgQueryCache(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testOrgQueryCache(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                      "chart 2");
+    testOrgQueryCache(emptyHead, vector<int>{1, 2}, "the empty chart");
+    testOrgQueryCache(singleEmployee, vector<int>{1, 2}, "the single employee chart");
+    {
+        Employee* cacheHead = new Employee(1, vector<int>{2, 3});
+        OrgQueryCache cache(cacheHead, 2);
+        vector<int> managers;
+        asserts(!cache.findManagersOfEmployee(4, managers) && managers.empty() &&
+                cache.findNumOfManagersBetween(4, 3) == Employee::NOT_FOUND,
+                "OrgQueryCache does not find employee 4 before it is added");
+
+        cacheHead->getDirectReports().at(0)->addDirectReport(4);
+        asserts(cache.findManagersOfEmployee(4, managers) && managers == vector<int>({2, 1}) &&
+                cache.findNumOfManagersBetween(3, 4) == 2 && cache.getNumInvalidations() == 1,
+                "OrgQueryCache drops its results when a direct report is added");
+
+        cache.findClosestSharedManager(2, 3);
+        cache.findNumOfManagersBetween(3, 4);
+        asserts(cache.size() == 2 && cache.getNumEvictions() == 1 && cache.getNumHits() == 1 &&
+                cache.getHitRate() == 1.0 / 6,
+                "OrgQueryCache of capacity 2 evicts the result used least recently");
+
+        // Changes to another chart keep the results
+        Employee* otherHead = new Employee(1, vector<int>{2});
+        otherHead->addDirectReport(3);
+        deleteWithoutTrace(otherHead);
+        asserts(cache.findNumOfManagersBetween(3, 4) == 2 && cache.getNumInvalidations() == 1,
+                "OrgQueryCache keeps its results when another chart changes");
+
+        deleteWithoutTrace(cacheHead);
+        cache.clear();
+        asserts(cache.size() == 0, "OrgQueryCache is empty after clear");
+    }
+    {
+        // A cache on an EmployeeIndex the caller keeps using
+        Employee* indexedHead = new Employee(1, vector<int>{2, 3});
+        EmployeeIndex index(indexedHead);
+        OrgQueryCache cache(index);
+        asserts(cache.findNumOfManagersBetween(2, 3) == 1 && cache.findNumOfManagersBetween(3, 2) == 1 &&
+                cache.getNumHits() == 1, "OrgQueryCache answers from the cache on a shared EmployeeIndex");
+        indexedHead->getDirectReports().at(1)->addDirectReport(4);
+        asserts(index.isEmployeePresentInOrg(4) && cache.findNumOfManagersBetween(2, 4) == 2 &&
+                cache.getNumInvalidations() == 1,
+                "OrgQueryCache and its shared EmployeeIndex both see a new direct report");
+        unsigned long long generation = index.getGeneration();
+        deleteWithoutTrace(indexedHead);
+        asserts(index.size() == 0 && index.getGeneration() == generation + 4,
+                "Deleting the 4 employees of a chart advances its EmployeeIndex generation by 4");
+    }
+    {
+        // Two caches on one chart share its index, and either can go first
+        Employee* twoHead = new Employee(1, vector<int>{2, 3});
+        OrgQueryCache* first = new OrgQueryCache(twoHead);
+        asserts(first->findNumOfManagersBetween(2, 4) == Employee::NOT_FOUND,
+                "The first OrgQueryCache on a chart does not find employee 4 before it is added");
+        {
+            OrgQueryCache second(twoHead);
+            asserts(second.findNumOfManagersBetween(2, 3) == 1 &&
+                    EmployeeIndex::attachedTo(twoHead) != nullptr,
+                    "A second OrgQueryCache on the chart shares its EmployeeIndex");
+        }
+        twoHead->getDirectReports().at(1)->addDirectReport(4);
+        asserts(first->findNumOfManagersBetween(2, 4) == 2 && first->getNumInvalidations() == 1,
+                "OrgQueryCache drops its results after another cache on the chart is destroyed");
+
+        OrgQueryCache* third = new OrgQueryCache(twoHead);
+        delete first;
+        twoHead->getDirectReports().at(0)->addDirectReport(5);
+        asserts(third->findNumOfManagersBetween(5, 4) == 3 && EmployeeIndex::attachedTo(twoHead) != nullptr,
+                "OrgQueryCache keeps tracking the chart after the cache that built the index is destroyed");
+        delete third;
+        asserts(EmployeeIndex::attachedTo(twoHead) == nullptr,
+                "The last OrgQueryCache on a chart deletes the index it shared");
+
+        // A cache reuses the caller's index, and one on a partly indexed chart reuses nothing
+        EmployeeIndex userIndex(twoHead);
+        {
+            OrgQueryCache onUserIndex(twoHead);
+            onUserIndex.findNumOfManagersBetween(2, 3);
+            twoHead->addDirectReport(6);
+            asserts(onUserIndex.findNumOfManagersBetween(6, 5) == 2 && userIndex.isEmployeePresentInOrg(6) &&
+                    onUserIndex.getNumInvalidations() == 1,
+                    "OrgQueryCache on a chart with an EmployeeIndex uses that index");
+        }
+        deleteWithoutTrace(twoHead);
+
+        Employee* partHead = new Employee(10, vector<int>{11, 12});
+        EmployeeIndex partIndex(partHead->getDirectReports().at(1));
+        {
+            OrgQueryCache untracked(partHead);
+            untracked.findNumOfManagersBetween(11, 13);
+            partHead->getDirectReports().at(1)->addDirectReport(13);
+            asserts(untracked.findNumOfManagersBetween(11, 13) == 2 && untracked.getNumHits() == 0,
+                    "OrgQueryCache reuses no result on a chart whose changes it cannot track");
+        }
+        deleteWithoutTrace(partHead);
+    }
+
+    // Test adding direct reports from a range, and reading them in place
+    {
+        int reportIDs[] = {2, 3, 4};
+        Employee* rangeHead = new Employee(1);
+        rangeHead->addDirectReports(reportIDs, reportIDs + 3);
+        const vector<Employee*> &reports = rangeHead->getDirectReports();
+        asserts(&reports == &rangeHead->getDirectReports() && reports.size() == 3 &&
+                reports[2]->getEmployeeID() == 4 && reports[0]->getManager() == rangeHead,
+                "getDirectReports returns the direct reports added from a range, without a copy");
+        deleteWithoutTrace(rangeHead);
+    }
+
+    // Test adding direct reports one small batch at a time: the list must grow geometrically
+    {
+        const int NUM_BATCHES = 80000;
+        Employee* batchHead = new Employee(1);
+        int numGrowths = 0;
+        size_t capacity = batchHead->getDirectReports().capacity();
+        for (int i = 0; i < NUM_BATCHES; i++) {
+            batchHead->addDirectReports(vector<int>{10 + i});
+            if (batchHead->getDirectReports().capacity() != capacity) {
+                capacity = batchHead->getDirectReports().capacity();
+                numGrowths++;
+            }
+        }
+        asserts((int)batchHead->getDirectReports().size() == NUM_BATCHES && numGrowths <= 20 &&
+                batchHead->getDirectReports().back()->getEmployeeID() == 10 + NUM_BATCHES - 1,
+                "addDirectReports called " + to_string(NUM_BATCHES) + " times grows the list " +
+                to_string(numGrowths) + " times");
+        deleteWithoutTrace(batchHead);
+    }
+
+    // Test CompactOrgtree against the Orgtree results, and direct reports spilling out of the nodes
+    testCompactOrgtree(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testCompactOrgtree(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                       "chart 2");
+    testCompactOrgtree(emptyHead, vector<int>{1, 2}, "the empty chart");
+    testCompactOrgtree(singleEmployee, vector<int>{1, 2}, "the single employee chart");
+    {
+        CompactOrgtree compact;
+        int compactHead = compact.addHead(1);
+        for (int i = 0; i < 10; i++) {
+            compact.addDirectReport(compactHead, 10 + i);
+        }
+        int last = compact.getDirectReport(compactHead, 9);
+        compact.addDirectReport(last, 30);
+        asserts(compact.addHead(2) == CompactOrgtree::NO_INDEX && compact.size() == 12 &&
+                compact.getNumDirectReports(compactHead) == 10 && compact.getEmployeeID(last) == 19 &&
+                compact.getManager(compact.indexOf(30)) == last && compact.findEmployeeLevel(30, 0) == 2 &&
+                compact.findNumOfManagersBetween(30, 10) == 2 && compact.findNumOfEmployeesUnder(1) == 11,
+                "CompactOrgtree keeps 10 direct reports after they spill out of the node");
+
+        vector<int> randomIDs, sampleIDs;
+        Employee* randomHead = buildRandomOrg(20000, randomIDs);
+        for (size_t i = 0; i < randomIDs.size(); i += 997) {
+            sampleIDs.push_back(randomIDs[i]);
+        }
+        sampleIDs.push_back(-2);
+        testCompactOrgtree(randomHead, sampleIDs, "a random chart of 20000 employees");
+        deleteWithoutTrace(randomHead);
+    }
+
+    // Test OrgMerkleTree hashes and diffs
+    {
+        Employee* before = new Employee(1, vector<int>{2, 3});
+        before->getDirectReports().at(0)->addDirectReports(vector<int>{4, 5});
+        before->getDirectReports().at(1)->addDirectReport(6);
+        before->getDirectReports().at(1)->getDirectReports().at(0)->addDirectReport(7);
+
+        // Same chart, with the direct reports of every manager in the opposite order
+        Employee* reordered = new Employee(1, vector<int>{3, 2});
+        reordered->getDirectReports().at(0)->addDirectReport(6);
+        reordered->getDirectReports().at(0)->getDirectReports().at(0)->addDirectReport(7);
+        reordered->getDirectReports().at(1)->addDirectReports(vector<int>{5, 4});
+
+        // 5 moves from 2 to 6, 7 is deleted, 8 and 9 are inserted
+        Employee* after = new Employee(1, vector<int>{2, 3});
+        after->getDirectReports().at(0)->addDirectReport(4);
+        after->getDirectReports().at(1)->addDirectReports(vector<int>{6, 8});
+        after->getDirectReports().at(1)->getDirectReports().at(0)->addDirectReport(5);
+        after->getDirectReports().at(1)->getDirectReports().at(1)->addDirectReport(9);
+
+        uint64_t hash = 0;
+        OrgMerkleTree hashes(before);
+        asserts(hashes.size() == 7 && hashes.getSubtreeHash(1, hash) && hash == hashes.getRootHash() &&
+                !hashes.getSubtreeHash(99, hash) && OrgMerkleTree(nullptr).getRootHash() == 0,
+                "OrgMerkleTree hashes the subtree of every employee");
+
+        OrgMerkleTree::Diff none, changes;
+        testOrgMerkleTree(before, reordered, none, "reordered direct reports");
+        OrgMerkleTree::diff(hashes, OrgMerkleTree(reordered), none);
+        asserts(none.empty() && none.numVisited == 2, "OrgMerkleTree only looks at the heads of identical charts");
+
+        changes.inserts = { {8, Employee::NOT_FOUND, 3}, {9, Employee::NOT_FOUND, 8} };
+        changes.moves = { {5, 2, 6} };
+        changes.deletes = { {7, 6, Employee::NOT_FOUND} };
+        testOrgMerkleTree(before, after, changes, "a move, a delete and two inserts");
+        changes.inserts = { {7, Employee::NOT_FOUND, 6} };
+        changes.moves = { {5, 6, 2} };
+        changes.deletes = { {8, 3, Employee::NOT_FOUND}, {9, 8, Employee::NOT_FOUND} };
+        testOrgMerkleTree(after, before, changes, "the reverse changes");
+        OrgMerkleTree::Diff everyone;
+        everyone.inserts = { {1, Employee::NOT_FOUND, Employee::NOT_FOUND}, {2, Employee::NOT_FOUND, 1},
+                             {4, Employee::NOT_FOUND, 2}, {5, Employee::NOT_FOUND, 2}, {3, Employee::NOT_FOUND, 1},
+                             {6, Employee::NOT_FOUND, 3}, {7, Employee::NOT_FOUND, 6} };
+        testOrgMerkleTree(nullptr, before, everyone, "a chart built from scratch");
+        deleteWithoutTrace(before);
+        deleteWithoutTrace(reordered);
+        deleteWithoutTrace(after);
+
+        // A manager and its direct report trade places, which needs the moves in the new chart's order
+        Employee* chain = new Employee(1, vector<int>{2});
+        chain->getDirectReports().at(0)->addDirectReport(3);
+        Employee* swapped = new Employee(1, vector<int>{3});
+        swapped->getDirectReports().at(0)->addDirectReport(2);
+        OrgMerkleTree::Diff swaps;
+        swaps.moves = { {3, 2, 1}, {2, 1, 3} };
+        testOrgMerkleTree(chain, swapped, swaps, "a manager swapped with its report");
+        deleteWithoutTrace(chain);
+        deleteWithoutTrace(swapped);
+
+        // One new employee deep in a large chart: only the way down to it is looked at
+        vector<int> ids, sameIDs;
+        Employee* randomBefore = buildRandomOrg(20000, ids);
+        Employee* randomAfter = buildRandomOrg(20000, sameIDs);
+        EmployeeIndex(randomAfter).findEmployee(ids[15000])->addDirectReport(2000000);
+        OrgMerkleTree::Diff inserted;
+        inserted.inserts = { {2000000, Employee::NOT_FOUND, ids[15000]} };
+        testOrgMerkleTree(randomBefore, randomAfter, inserted, "one insert in a random chart of 20000 employees");
+        OrgMerkleTree::diff(OrgMerkleTree(randomBefore), OrgMerkleTree(randomAfter), inserted);
+        asserts(inserted.numVisited < 20000 / 4,
+                "OrgMerkleTree looks at " + to_string(inserted.numVisited) + " of 20000 employees to find one insert");
+        deleteWithoutTrace(randomBefore);
+        deleteWithoutTrace(randomAfter);
+    }
+
+    // Test the OrgTraversal visiting orders and the OrgWriter sinks
+    testOrgTraversal(head);
+    testOrgWriter();
+
+    // Test OrgLevelIndex levels and headcounts on all charts
+    testOrgLevelIndex(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99},
+                      vector<vector<int> >{{1}, {2, 3, 4}, {5, 6, 7, 8, 9}, {10, 11, 12}}, "chart 1");
+    testOrgLevelIndex(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                      vector<vector<int> >{{100}, {200, 300}, {201, 202, 301}, {203, 302}, {204, 303}, {401, 402}},
+                      "chart 2");
+    testOrgLevelIndex(emptyHead, vector<int>{1, 2}, vector<vector<int> >(), "the empty chart");
+    testOrgLevelIndex(singleEmployee, vector<int>{1, 2}, vector<vector<int> >{{1}}, "the single employee chart");
+
+    // Test OrgPathIndex path aggregates on all charts
+    testOrgPathIndex(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testOrgPathIndex(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                     "chart 2");
+    testOrgPathIndex(emptyHead, vector<int>{1, 2}, "the empty chart");
+    testOrgPathIndex(singleEmployee, vector<int>{1, 2}, "the single employee chart");
+
+    // Test OrgBatchQuery against the Orgtree results on all charts
+    testOrgBatchQuery(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testOrgBatchQuery(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                      "chart 2");
+    testOrgBatchQuery(emptyHead, vector<int>{1, 2}, "the empty chart");
+
+    // Test ParallelOrgtree against the Orgtree results on all charts
+    testParallelOrgtree(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, 12, "chart 1");
+    testParallelOrgtree(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999}, 12,
+                        "chart 2");
+    testParallelOrgtree(emptyHead, vector<int>{1, 2}, 0, "the empty chart");
+    testParallelOrgtree(singleEmployee, vector<int>{1, 2}, 1, "the single employee chart");
+
+    // Test DynamicOrgtree reorgs against Orgtree on copies of the reorganized chart
+    testDynamicOrgtree(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999});
+
+    // Test OrgSnapshot against FlatOrgtree on all charts
+    testOrgSnapshot(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testOrgSnapshot(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999}, "chart 2");
+    testOrgSnapshot(emptyHead, vector<int>{1, 2}, "the empty chart");
+    {
+        Employee* minHead = new Employee(1, vector<int>{INT_MIN, 2});
+        minHead->getDirectReports().at(0)->addDirectReport(3);
+        testOrgSnapshot(minHead, vector<int>{1, INT_MIN, 2, 3, -2}, "a chart with employee INT_MIN");
+        FlatOrgtree minFlat(minHead);
+        OrgSnapshot::write(minFlat, "orgsnapshot_test.bin");
+        OrgSnapshot* minSnapshot = OrgSnapshot::open("orgsnapshot_test.bin", true);
+        asserts(minSnapshot != nullptr && minSnapshot->isEmployeePresentInOrg(INT_MIN) &&
+                minSnapshot->findNumOfEmployeesUnder(INT_MIN) == 1,
+                "OrgSnapshot finds employee INT_MIN");
+        delete minSnapshot;
+        remove("orgsnapshot_test.bin");
+        deleteWithoutTrace(minHead);
+    }
+
+    // Test SuccinctOrgtree against FlatOrgtree on all charts, and on a chart spanning many blocks
+    testSuccinctOrgtree(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testSuccinctOrgtree(head1, vector<int>{100, 200, 300, 201, 202, 301, 203, 302, 204, 303, 401, 402, 999},
+                        "chart 2");
+    testSuccinctOrgtree(emptyHead, vector<int>{1, 2}, "the empty chart");
+    testSuccinctOrgtree(singleEmployee, vector<int>{1, 2}, "the single employee chart");
+    {
+        vector<int> randomIDs, sampleIDs;
+        Employee* randomHead = buildRandomOrg(20000, randomIDs);
+        for (size_t i = 0; i < randomIDs.size(); i += 331) {
+            sampleIDs.push_back(randomIDs[i]);
+        }
+        sampleIDs.push_back(randomIDs.back());
+        sampleIDs.push_back(-2);
+        testSuccinctOrgtree(randomHead, sampleIDs, "a random chart of 20000 employees");
+        deleteWithoutTrace(randomHead);
+    }
+
+    // Test OrgLoader by writing chart 2 out and reading it back
+    testOrgLoader(head1);
+
+    // Test ConcurrentOrgtree snapshots against a writer
+    testConcurrentOrgtree(head1);
+
+    // Test building, deleting and releasing charts in an EmployeeArena
+    testEmployeeArena();
+
+    // Test EmployeeIndex against the Orgtree results, and keeping it in sync with new direct reports
+    testEmployeeIndex(head, vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -2, 99}, "chart 1");
+    testEmployeeIndex(emptyHead, vector<int>{1}, "the empty chart");
+    {
+        EmployeeIndex index(head1);
+        asserts(index.size() == 12 && index.findEmployee(303) == e303,
+                "EmployeeIndex finds all 12 employees of chart 2");
+
+        e303->addDirectReports(vector<int>{501, 502});
+        e201->addDirectReport(503);
+        vector<int> indexManagers;
+        asserts(index.isEmployeePresentInOrg(502) && index.isEmployeePresentInOrg(503) && index.size() == 15,
+                "EmployeeIndex picks up direct reports added after it was built");
+        asserts(index.findManagersOfEmployee(502, indexManagers) &&
+                indexManagers == vector<int>({303, 302, 202, 200, 100}),
+                "EmployeeIndex should return (303, 302, 202, 200, 100) as managers of new employee 502");
+
+        Employee* subHead = new Employee(700, vector<int>{701, 702});
+        EmployeeIndex subIndex(subHead);
+        subHead->getDirectReports().at(0)->addDirectReport(703);
+        asserts(subIndex.size() == 4, "EmployeeIndex of a separate chart has 4 employees");
+        Orgtree::deleteOrgtree(subHead);
+        asserts(subIndex.size() == 0 && !subIndex.isEmployeePresentInOrg(703),
+                "Deleted employees are removed from their EmployeeIndex");
+    }
+
+    // Chart 2 has no index any more, so a new one indexes the employees added above
+    testEmployeeIndex(head1, vector<int>{100, 303, 401, 501, 502, 503, 999}, "chart 2 after adding employees");
+
+    // Test that a chart keeps its first EmployeeIndex when a second one is built on it
+    {
+        Employee* sharedHead = new Employee(1, vector<int>{2, 3});
+        EmployeeIndex first(sharedHead);
+        {
+            EmployeeIndex second(sharedHead);
+            EmployeeIndex subtree(sharedHead->getDirectReports().at(1));
+            asserts(first.isAttached() && !second.isAttached() && second.size() == 0 && !subtree.isAttached() &&
+                    EmployeeIndex::attachedTo(sharedHead->getDirectReports().at(1)) == &first,
+                    "EmployeeIndex refuses a chart that has an index already");
+        }
+        sharedHead->getDirectReports().at(1)->addDirectReport(4);
+        asserts(first.isEmployeePresentInOrg(4) && first.size() == 4,
+                "EmployeeIndex keeps indexing its chart after a refused index is destroyed");
+        deleteWithoutTrace(sharedHead);
+        asserts(first.size() == 0, "EmployeeIndex drops the employees of its deleted chart");
+    }
+    {
+        // An index of a subtree makes an index of the whole chart give back what it attached
+        Employee* partHead = new Employee(1, vector<int>{2, 3});
+        EmployeeIndex part(partHead->getDirectReports().at(1));
+        EmployeeIndex whole(partHead);
+        asserts(part.isAttached() && !whole.isAttached() && whole.size() == 0 &&
+                EmployeeIndex::attachedTo(partHead) == nullptr &&
+                EmployeeIndex::attachedTo(partHead->getDirectReports().at(0)) == nullptr,
+                "EmployeeIndex detaches the employees it attached when it finds an indexed subtree");
+        deleteWithoutTrace(partHead);
+    }
+
+    // Test INT_MIN, the empty slot key of IdHashMap, as an employee ID
+    {
+        IdHashMap<int> map;
+        map.put(INT_MIN, 1);
+        map.put(7, 2);
+        int numVisited = 0;
+        map.forEach([&numVisited](int key, int value) {
+            numVisited++;
+        });
+        asserts(map.size() == 2 && *map.find(INT_MIN) == 1 && numVisited == 2 && map.erase(INT_MIN) &&
+                !map.contains(INT_MIN) && !map.erase(INT_MIN) && map.size() == 1 && *map.find(7) == 2,
+                "IdHashMap keeps an entry with INT_MIN as its key");
+
+        Employee* minHead = new Employee(1, vector<int>{INT_MIN, 2});
+        minHead->getDirectReports().at(0)->addDirectReport(3);
+        EmployeeIndex minIndex(minHead);
+        FlatOrgtree minFlat(minHead);
+        vector<int> minManagers;
+        asserts(minIndex.size() == 4 && minIndex.findManagersOfEmployee(3, minManagers) &&
+                minManagers == vector<int>({INT_MIN, 1}) && minFlat.isEmployeePresentInOrg(INT_MIN) &&
+                minFlat.findNumOfEmployeesUnder(INT_MIN) == 1,
+                "EmployeeIndex and FlatOrgtree find employee INT_MIN");
+
+        Employee* loaded = loadCsvText("1,\n-2147483648,1\n3,-2147483648\n");
+        asserts(loaded != nullptr && loaded->getDirectReports().at(0)->getEmployeeID() == INT_MIN &&
+                loaded->getDirectReports().at(0)->getDirectReports().at(0)->getEmployeeID() == 3,
+                "OrgLoader loads employee INT_MIN");
+        deleteWithoutTrace(loaded);
+
+        Orgtree::deleteOrgtree(minHead, nullptr);
+        asserts(minIndex.size() == 0 && !minIndex.isEmployeePresentInOrg(INT_MIN),
+                "EmployeeIndex drops employee INT_MIN when it is deleted");
+    }
+
+
+    // Test every function on a chain that would overflow the call stack if they recursed
+    testDeepChain(1000000);
+
+
     // Test deleteOrgtree function
     // VERY IMPORTANT: Related to valgrind memory leaking detection testing,
     // You MUST call your deleteOrgtree function at the end of this driver testing code
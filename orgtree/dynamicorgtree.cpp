@@ -0,0 +1,494 @@
+#include "dynamicorgtree.h"
+
+#include <utility>  // pair
+
+const int DynamicOrgtree::NONE;
+
+/**
+ * Copy the organization chart under head.
+ *
+ * <p>
+ * The chart is walked once in pre-order with an explicit stack. Every employee starts as its
+ * own preferred path, pointing at its manager with a path-parent link, which is already a valid
+ * link-cut tree, so building takes O(N).
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ */
+DynamicOrgtree::DynamicOrgtree(Employee* head) : head(NONE) {
+
+    // Each stack entry is an employee still to be copied, together with its manager's node
+    vector<pair<Employee*, int> > toVisit;
+    if (head != nullptr) {
+        toVisit.push_back(make_pair(head, NONE));
+    }
+
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back().first;
+        int manager = toVisit.back().second;
+        toVisit.pop_back();
+
+        int node = newNode(employee->getEmployeeID());
+        if (manager == NONE) {
+            this->head = node;
+        }
+        else {
+            nodes[node].parent = manager;
+            nodes[node].manager = manager;
+            appendReport(manager, node);
+        }
+
+        // Push the direct reports in reverse, so that they are copied in their original order
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (int i = (int)directReports.size() - 1; i >= 0; i--) {
+            toVisit.push_back(make_pair(directReports[i], node));
+        }
+    }
+}
+
+int DynamicOrgtree::newNode(int e_id) {
+    int node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        node = (int)nodes.size();
+        nodes.push_back(Node());
+    }
+
+    Node &n = nodes[node];
+    n.employeeID = e_id;
+    n.left = n.right = n.parent = NONE;
+    n.size = 1;
+    n.manager = NONE;
+    n.firstReport = n.lastReport = NONE;
+    n.prevSibling = n.nextSibling = NONE;
+    nodeByID.put(e_id, node);
+    return node;
+}
+
+void DynamicOrgtree::freeNode(int node) {
+    nodeByID.erase(nodes[node].employeeID);
+    freeNodes.push_back(node);
+}
+
+int DynamicOrgtree::nodeOf(int e_id) const {
+    const int* node = nodeByID.find(e_id);
+    return (node == nullptr) ? NONE : *node;
+}
+
+// A node is the root of its splay tree if its parent link is missing or only a path-parent link
+bool DynamicOrgtree::isSplayRoot(int x) const {
+    int p = nodes[x].parent;
+    return p == NONE || (nodes[p].left != x && nodes[p].right != x);
+}
+
+void DynamicOrgtree::update(int x) {
+    int left = nodes[x].left;
+    int right = nodes[x].right;
+    nodes[x].size = 1 + (left == NONE ? 0 : nodes[left].size) + (right == NONE ? 0 : nodes[right].size);
+}
+
+// Rotate x above its splay tree parent, keeping the level order of the path
+void DynamicOrgtree::rotate(int x) {
+    int p = nodes[x].parent;
+    int g = nodes[p].parent;
+    bool parentIsRoot = isSplayRoot(p);
+
+    if (nodes[p].left == x) {
+        nodes[p].left = nodes[x].right;
+        if (nodes[x].right != NONE) {
+            nodes[nodes[x].right].parent = p;
+        }
+        nodes[x].right = p;
+    }
+    else {
+        nodes[p].right = nodes[x].left;
+        if (nodes[x].left != NONE) {
+            nodes[nodes[x].left].parent = p;
+        }
+        nodes[x].left = p;
+    }
+
+    // x takes over p's place, including p's path-parent link if p was the root
+    nodes[p].parent = x;
+    nodes[x].parent = g;
+    if (!parentIsRoot) {
+        if (nodes[g].left == p) {
+            nodes[g].left = x;
+        }
+        else {
+            nodes[g].right = x;
+        }
+    }
+    update(p);
+    update(x);
+}
+
+// Move x to the root of its splay tree
+void DynamicOrgtree::splay(int x) {
+    while (!isSplayRoot(x)) {
+        int p = nodes[x].parent;
+        if (!isSplayRoot(p)) {
+            int g = nodes[p].parent;
+            bool sameSide = (nodes[g].left == p) == (nodes[p].left == x);
+            rotate(sameSide ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+/**
+ * Make the management chain from the head down to x one preferred path, with x at the root
+ * of its splay tree and nothing below x on the path.
+ *
+ * @return  the last node where the chain joined the path that was exposed before,
+ *          which is the closest shared manager of x and the previously accessed node
+ */
+int DynamicOrgtree::access(int x) {
+    int last = NONE;
+    for (int y = x; y != NONE; y = nodes[y].parent) {
+        splay(y);
+        nodes[y].right = last;
+        update(y);
+        last = y;
+    }
+    splay(x);
+    return last;
+}
+
+// Attach the head of a separate tree under manager
+void DynamicOrgtree::link(int child, int manager) {
+    access(child);
+    nodes[child].parent = manager;
+}
+
+// Detach child, with everyone under it, from its manager
+void DynamicOrgtree::cut(int child) {
+    access(child);
+    int above = nodes[child].left;
+    if (above != NONE) {
+        nodes[above].parent = NONE;
+        nodes[child].left = NONE;
+        update(child);
+    }
+}
+
+// Level of x below the head: after access(x), everyone on its splay tree's left is a manager of x
+int DynamicOrgtree::depth(int x) {
+    access(x);
+    int above = nodes[x].left;
+    return (above == NONE) ? 0 : nodes[above].size;
+}
+
+int DynamicOrgtree::closestSharedManager(int x, int y) {
+    access(x);
+    return access(y);
+}
+
+void DynamicOrgtree::appendReport(int manager, int report) {
+    nodes[report].prevSibling = nodes[manager].lastReport;
+    nodes[report].nextSibling = NONE;
+    if (nodes[manager].lastReport == NONE) {
+        nodes[manager].firstReport = report;
+    }
+    else {
+        nodes[nodes[manager].lastReport].nextSibling = report;
+    }
+    nodes[manager].lastReport = report;
+}
+
+void DynamicOrgtree::unlinkReport(int report) {
+    int manager = nodes[report].manager;
+    int prev = nodes[report].prevSibling;
+    int next = nodes[report].nextSibling;
+
+    if (prev == NONE) {
+        nodes[manager].firstReport = next;
+    }
+    else {
+        nodes[prev].nextSibling = next;
+    }
+    if (next == NONE) {
+        nodes[manager].lastReport = prev;
+    }
+    else {
+        nodes[next].prevSibling = prev;
+    }
+    nodes[report].prevSibling = nodes[report].nextSibling = NONE;
+}
+
+int DynamicOrgtree::size() const {
+    return (int)nodeByID.size();
+}
+
+int DynamicOrgtree::getHeadID() const {
+    return (head == NONE) ? Employee::EMPTY_EMPLOYEEID : nodes[head].employeeID;
+}
+
+bool DynamicOrgtree::isEmployeePresentInOrg(int e_id) const {
+    return nodeOf(e_id) != NONE;
+}
+
+int DynamicOrgtree::getManagerID(int e_id) const {
+    int node = nodeOf(e_id);
+    if (node == NONE || nodes[node].manager == NONE) {
+        return Employee::NOT_FOUND;
+    }
+    return nodes[nodes[node].manager].employeeID;
+}
+
+/**
+ * Add a new employee as the last direct report of a manager.
+ *
+ * <p>
+ * A new employee is a path of its own, so a path-parent link to the manager is all it needs.
+ *
+ * @param  e_id id of the new employee, must not be in the chart yet
+ * @param  m_id id of the manager, or Employee::EMPTY_EMPLOYEEID to add the head of an empty chart
+ * @return   true if the employee was added
+ */
+bool DynamicOrgtree::addEmployee(int e_id, int m_id) {
+
+    if (nodeOf(e_id) != NONE) {
+        return false;
+    }
+
+    if (m_id == Employee::EMPTY_EMPLOYEEID) {
+        if (head != NONE) {
+            return false;
+        }
+        head = newNode(e_id);
+        return true;
+    }
+
+    int manager = nodeOf(m_id);
+    if (manager == NONE) {
+        return false;
+    }
+
+    int node = newNode(e_id);
+    nodes[node].parent = manager;
+    nodes[node].manager = manager;
+    appendReport(manager, node);
+    return true;
+}
+
+/**
+ * Move an employee, together with everyone under them, under a new manager.
+ *
+ * @param  e_id id of the employee to move
+ * @param  m_id id of the new manager
+ * @return   true if the employee was moved
+ */
+bool DynamicOrgtree::moveEmployee(int e_id, int m_id) {
+
+    int node = nodeOf(e_id);
+    int manager = nodeOf(m_id);
+    if (node == NONE || manager == NONE || node == head) {
+        return false;
+    }
+
+    // Moving an employee under itself or one of its own reports would cut the chart off from the head
+    if (closestSharedManager(node, manager) == node) {
+        return false;
+    }
+
+    cut(node);
+    unlinkReport(node);
+    link(node, manager);
+    nodes[node].manager = manager;
+    appendReport(manager, node);
+    return true;
+}
+
+/**
+ * Remove an employee, moving its direct reports up to its manager.
+ *
+ * @param  e_id id of the employee to remove
+ * @return   true if the employee was removed
+ */
+bool DynamicOrgtree::removeEmployee(int e_id) {
+
+    int node = nodeOf(e_id);
+    if (node == NONE) {
+        return false;
+    }
+
+    if (node == head) {
+        // Only a head with at most one direct report can be replaced
+        int report = nodes[node].firstReport;
+        if (report != NONE && nodes[report].nextSibling != NONE) {
+            return false;
+        }
+        if (report != NONE) {
+            cut(report);
+            nodes[report].manager = NONE;
+            nodes[report].prevSibling = nodes[report].nextSibling = NONE;
+        }
+        head = report;
+        freeNode(node);
+        return true;
+    }
+
+    // Relink every direct report to the manager
+    int manager = nodes[node].manager;
+    for (int report = nodes[node].firstReport; report != NONE; report = nodes[report].nextSibling) {
+        cut(report);
+        link(report, manager);
+        nodes[report].manager = manager;
+    }
+
+    // The direct reports take the employee's place in the manager's list
+    int first = nodes[node].firstReport;
+    int last = nodes[node].lastReport;
+    if (first == NONE) {
+        unlinkReport(node);
+    }
+    else {
+        int prev = nodes[node].prevSibling;
+        int next = nodes[node].nextSibling;
+        nodes[first].prevSibling = prev;
+        nodes[last].nextSibling = next;
+        if (prev == NONE) {
+            nodes[manager].firstReport = first;
+        }
+        else {
+            nodes[prev].nextSibling = first;
+        }
+        if (next == NONE) {
+            nodes[manager].lastReport = last;
+        }
+        else {
+            nodes[next].prevSibling = last;
+        }
+    }
+
+    // Nothing hangs off the employee anymore, so cutting it leaves it alone
+    cut(node);
+    freeNode(node);
+    return true;
+}
+
+/**
+ * Remove an employee together with everyone under them.
+ *
+ * <p>
+ * Once the subtree is cut off, no splay tree or path-parent link outside of it refers to its nodes,
+ * so they can be freed with a walk over the direct report lists.
+ *
+ * @param  e_id id of the head of the subtree to remove
+ * @return   number of employees removed
+ */
+int DynamicOrgtree::removeSubtree(int e_id) {
+
+    int node = nodeOf(e_id);
+    if (node == NONE) {
+        return 0;
+    }
+
+    if (node == head) {
+        head = NONE;
+    }
+    else {
+        cut(node);
+        unlinkReport(node);
+    }
+
+    int numRemoved = 0;
+    vector<int> toRemove(1, node);
+    while (!toRemove.empty()) {
+        int removed = toRemove.back();
+        toRemove.pop_back();
+        for (int report = nodes[removed].firstReport; report != NONE; report = nodes[report].nextSibling) {
+            toRemove.push_back(report);
+        }
+        freeNode(removed);
+        numRemoved++;
+    }
+    return numRemoved;
+}
+
+int DynamicOrgtree::findEmployeeLevel(int e_id, int headLevel) {
+    int node = nodeOf(e_id);
+    return (node == NONE) ? Employee::NOT_FOUND : headLevel + depth(node);
+}
+
+bool DynamicOrgtree::isManagerOf(int m_id, int e_id) {
+    int manager = nodeOf(m_id);
+    int node = nodeOf(e_id);
+    if (manager == NONE || node == NONE || manager == node) {
+        return false;
+    }
+    return closestSharedManager(manager, node) == manager;
+}
+
+int DynamicOrgtree::findClosestSharedManager(int e1_id, int e2_id) {
+
+    int e1 = nodeOf(e1_id);
+    int e2 = nodeOf(e2_id);
+
+    if (e1 == NONE && e2 == NONE) {
+        return Employee::NOT_FOUND;
+    }
+    if (e2 == NONE) {
+        return e1_id;
+    }
+    if (e1 == NONE) {
+        return e2_id;
+    }
+    return nodes[closestSharedManager(e1, e2)].employeeID;
+}
+
+/**
+ * Calculate the number of managers between employee e1 and employee e2.
+ *
+ * <p>
+ * number of edges between e1 and closest shared manager +
+ * number of edges between e2 and closest shared manager - 1
+ */
+int DynamicOrgtree::findNumOfManagersBetween(int e1_id, int e2_id) {
+
+    int e1 = nodeOf(e1_id);
+    int e2 = nodeOf(e2_id);
+
+    if (e1 == NONE || e2 == NONE) {
+        return Employee::NOT_FOUND;
+    }
+
+    int sharedManager = closestSharedManager(e1, e2);
+    return depth(e1) + depth(e2) - 2 * depth(sharedManager) - 1;
+}
+
+/**
+ * Copy the current chart into new Employee nodes, walking the direct report lists with an explicit stack.
+ */
+Employee* DynamicOrgtree::buildOrgtree() const {
+
+    if (head == NONE) {
+        return nullptr;
+    }
+
+    Employee* copyHead = new Employee(nodes[head].employeeID);
+    vector<pair<Employee*, int> > toCopy(1, make_pair(copyHead, head));
+
+    while (!toCopy.empty()) {
+        Employee* employee = toCopy.back().first;
+        int node = toCopy.back().second;
+        toCopy.pop_back();
+
+        vector<int> reportIDs;
+        vector<int> reportNodes;
+        for (int report = nodes[node].firstReport; report != NONE; report = nodes[report].nextSibling) {
+            reportIDs.push_back(nodes[report].employeeID);
+            reportNodes.push_back(report);
+        }
+        employee->addDirectReports(reportIDs);
+
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (size_t i = 0; i < directReports.size(); i++) {
+            toCopy.push_back(make_pair(directReports[i], reportNodes[i]));
+        }
+    }
+    return copyHead;
+}
@@ -0,0 +1,176 @@
+#ifndef DYNAMICORGTREE_H
+#define DYNAMICORGTREE_H
+
+#include <vector>
+
+#include "orgtree.h"
+#include "idhashmap.h"
+
+using namespace std;
+
+// An organization chart that supports reorgs: employees can be added, removed, and moved
+// together with their whole subtree under a new manager, without rebuilding anything.
+//
+// The chart is kept as a link-cut tree over the employee IDs. Every management chain is split
+// into preferred paths, and each path is a splay tree ordered by level, so moving a subtree is
+// one cut and one link, and the closest shared manager of two employees is found by exposing
+// the path from the head to each of them. Every operation takes O(log N) amortized time,
+// except removals, which also touch each direct report (or subtree member) of the removed employee.
+//
+// Next to the link-cut tree, every employee keeps its direct reports in a linked list, in the
+// order they were added, so buildOrgtree() can copy the chart back into Employee nodes.
+//
+// Queries restructure the splay trees, so they are not const, and a chart must not be used
+// from several threads at once.
+class DynamicOrgtree {
+
+private:
+    static const int NONE = -1;     // null node index
+
+    struct Node {
+        int employeeID;
+        int left, right;            // children in the splay tree of the preferred path
+        int parent;                 // splay tree parent, or the path-parent of a splay tree root
+        int size;                   // number of nodes in this splay subtree
+        int manager;                // direct manager in the chart, NONE for the head
+        int firstReport, lastReport;        // list of direct reports
+        int prevSibling, nextSibling;       // neighbours in the manager's list
+    };
+
+    vector<Node> nodes;
+    vector<int> freeNodes;          // indices of removed nodes, reused first
+    IdHashMap<int> nodeByID;        // employee ID to node index
+    int head;
+
+    int newNode(int e_id);
+    void freeNode(int node);
+    int nodeOf(int e_id) const;
+
+    // Link-cut tree operations
+    bool isSplayRoot(int x) const;
+    void update(int x);
+    void rotate(int x);
+    void splay(int x);
+    int access(int x);
+    void link(int child, int manager);
+    void cut(int child);
+    int depth(int x);
+    int closestSharedManager(int x, int y);
+
+    // Direct report lists
+    void appendReport(int manager, int report);
+    void unlinkReport(int report);
+
+public:
+    /**
+     * Copy the organization chart under head.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit DynamicOrgtree(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    // Employee ID of the head, Employee::EMPTY_EMPLOYEEID for an empty chart
+    int getHeadID() const;
+
+    // Check if an employee is present in the chart. O(1)
+    bool isEmployeePresentInOrg(int e_id) const;
+
+    // Employee ID of the direct manager, Employee::NOT_FOUND for the head or a missing employee. O(1)
+    int getManagerID(int e_id) const;
+
+    /**
+     * Add a new employee as the last direct report of a manager. O(log N) amortized
+     *
+     * @param  e_id id of the new employee, must not be in the chart yet
+     * @param  m_id id of the manager, or Employee::EMPTY_EMPLOYEEID to add the head of an empty chart
+     * @return   true if the employee was added,
+     *           false if e_id is already present, or the manager is not present
+     */
+    bool addEmployee(int e_id, int m_id);
+
+    /**
+     * Move an employee, together with everyone under them, to become the last direct report
+     * of a new manager. O(log N) amortized
+     *
+     * @param  e_id id of the employee to move
+     * @param  m_id id of the new manager
+     * @return   true if the employee was moved,
+     *           false if either is missing, e is the head, or m is e or one of e's reports
+     */
+    bool moveEmployee(int e_id, int m_id);
+
+    /**
+     * Remove an employee. Its direct reports take its place in its manager's list of direct reports.
+     * O(log N) amortized per direct report
+     *
+     * @param  e_id id of the employee to remove
+     * @return   true if the employee was removed,
+     *           false if e_id is missing, or is a head with more than one direct report
+     *           (a head with one direct report is replaced by that report)
+     */
+    bool removeEmployee(int e_id);
+
+    /**
+     * Remove an employee together with everyone under them. O(log N) amortized plus O(size of the subtree)
+     *
+     * @param  e_id id of the head of the subtree to remove
+     * @return   number of employees removed, 0 if e_id is missing
+     */
+    int removeSubtree(int e_id);
+
+    /**
+     * Find the level of an employee. O(log N) amortized
+     *
+     * @param  e_id      the employee id being searched
+     * @param  headLevel the level of the head employee of the organization
+     * @return  level of the employee in the org chart
+     *          returns Employee::NOT_FOUND if e_id is not present
+     */
+    int findEmployeeLevel(int e_id, int headLevel);
+
+    /**
+     * Check if employee m is a manager of employee e, directly or further up the chart. O(log N) amortized
+     *
+     * @param  m_id id of the possible manager
+     * @param  e_id id of the employee
+     * @return   true if both are present and m is a manager of e, false otherwise
+     */
+    bool isManagerOf(int m_id, int e_id);
+
+    /**
+     * Find the closest shared manager of two employees e1 and e2. O(log N) amortized
+     * Same result as Orgtree::findClosestSharedManager on the same chart.
+     *
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   employee ID of the closest shared manager of e1 and e2
+     *           if neither e1 or e2 is present, returns Employee::NOT_FOUND
+     *           if only one of e1 and e2 is present, returns the one that is present
+     */
+    int findClosestSharedManager(int e1_id, int e2_id);
+
+    /**
+     * Calculate the number of managers between employee e1 and employee e2. O(log N) amortized
+     * Same result as Orgtree::findNumOfManagersBetween on the same chart.
+     *
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   number of managers between employee e1 and employee e2
+     *           returns Employee::NOT_FOUND if either e1 or e2 is not present in the chart
+     */
+    int findNumOfManagersBetween(int e1_id, int e2_id);
+
+    /**
+     * Copy the current chart into new Employee nodes, keeping the order of the direct reports.
+     * Delete the copy with Orgtree::deleteOrgtree.
+     *
+     * @return  the head of the copy, nullptr for an empty chart
+     */
+    Employee* buildOrgtree() const;
+
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "employeearena.h"
+
+#include <new>      // placement new
+
+const size_t EmployeeArena::DEFAULT_CHUNK_SIZE;
+
+EmployeeArena::EmployeeArena(size_t chunkSize)
+    : chunkSize(chunkSize > 0 ? chunkSize : 1), used(0), numLive(0) {
+}
+
+EmployeeArena::~EmployeeArena() {
+    release();
+}
+
+/**
+ * Hand out a free slot: a slot of a deleted employee, or the next slot of the last chunk.
+ */
+EmployeeArena::Slot* EmployeeArena::allocate() {
+    if (!freeSlots.empty()) {
+        Slot* slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    if (chunks.empty() || used == chunkSize) {
+        Slot* chunk = new Slot[chunkSize];
+        for (size_t i = 0; i < chunkSize; i++) {
+            chunk[i].live = false;
+        }
+        chunks.push_back(chunk);
+        used = 0;
+    }
+    return &chunks.back()[used++];
+}
+
+Employee* EmployeeArena::newEmployee(int id) {
+    Slot* slot = allocate();
+    Employee* employee = new (&slot->storage) Employee(id);
+    employee->arena = this;
+    slot->live = true;
+    numLive++;
+    return employee;
+}
+
+Employee* EmployeeArena::newEmployee(int id, const vector<int> &dReports) {
+    // The arena is set before the direct reports are added, so they come from the arena too
+    Employee* employee = newEmployee(id);
+    employee->addDirectReports(dReports);
+    return employee;
+}
+
+/**
+ * Destroy one employee and keep its slot for reuse.
+ * The storage is the first member of the slot, so the employee's address is the slot's.
+ */
+void EmployeeArena::deleteEmployee(Employee* employee) {
+    Slot* slot = reinterpret_cast<Slot*>(employee);
+    employee->~Employee();
+    slot->live = false;
+    freeSlots.push_back(slot);
+    numLive--;
+}
+
+/**
+ * Destroy every live employee, chunk by chunk, and free the chunks.
+ *
+ * <p>
+ * The employees are destroyed in allocation order rather than along the chart, so their
+ * direct report lists are freed without following a single pointer between employees.
+ */
+void EmployeeArena::release() {
+    for (size_t c = 0; c < chunks.size(); c++) {
+        size_t end = (c + 1 == chunks.size()) ? used : chunkSize;
+        for (size_t i = 0; i < end; i++) {
+            if (chunks[c][i].live) {
+                reinterpret_cast<Employee*>(&chunks[c][i].storage)->~Employee();
+            }
+        }
+        delete[] chunks[c];
+    }
+    chunks.clear();
+    freeSlots.clear();
+    used = 0;
+    numLive = 0;
+}
+
+size_t EmployeeArena::size() const {
+    return numLive;
+}
@@ -0,0 +1,89 @@
+#ifndef EMPLOYEEARENA_H
+#define EMPLOYEEARENA_H
+
+#include <stddef.h>
+#include <type_traits>
+#include <vector>
+
+#include "orgtree.h"
+
+using namespace std;
+
+// A pool that allocates Employee nodes in large chunks and releases a whole chart at once.
+//
+// Employees created by the arena belong to it, and so do all direct reports later added to
+// them with addDirectReport / addDirectReports. Memory comes from fixed-size chunks instead
+// of one heap allocation per employee, and release() (or the destructor) destroys every
+// employee that is still alive and frees the chunks, without walking the chart.
+//
+// Orgtree::deleteOrgtree works on arena employees too: their slots are returned to the
+// arena and reused by the next employees it creates. The arena must outlive the charts built
+// in it, and it is not thread-safe.
+class EmployeeArena {
+
+public:
+    // Number of employees per chunk
+    static const size_t DEFAULT_CHUNK_SIZE = 4096;
+
+private:
+    // Storage for one employee, and whether an employee is alive in it
+    struct Slot {
+        typename aligned_storage<sizeof(Employee), alignof(Employee)>::type storage;
+        bool live;
+    };
+
+    size_t chunkSize;
+    vector<Slot*> chunks;
+    size_t used;                // slots handed out from the last chunk
+    vector<Slot*> freeSlots;    // slots of deleted employees, reused first
+    size_t numLive;
+
+    Slot* allocate();
+
+    // Called by Orgtree::deleteOrgtree
+    friend class Orgtree;
+    void deleteEmployee(Employee* employee);
+
+public:
+    /**
+     * Create an empty arena.
+     *
+     * @param  chunkSize number of employees per chunk, at least 1
+     */
+    explicit EmployeeArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    // Releases every employee of the arena
+    ~EmployeeArena();
+
+    EmployeeArena(const EmployeeArena&) = delete;
+    EmployeeArena& operator=(const EmployeeArena&) = delete;
+
+    /**
+     * Create an employee in the arena, like new Employee(id).
+     *
+     * @param  id the employee id
+     * @return    the new employee, owned by the arena
+     */
+    Employee* newEmployee(int id);
+
+    /**
+     * Create an employee and its direct reports in the arena, like new Employee(id, dReports).
+     *
+     * @param  id       the employee id
+     * @param  dReports ids of the direct reports
+     * @return          the new employee, owned by the arena
+     */
+    Employee* newEmployee(int id, const vector<int> &dReports);
+
+    /**
+     * Destroy every employee that is still alive and free all chunks.
+     * Every Employee pointer into the arena is invalid afterwards.
+     */
+    void release();
+
+    // Number of employees alive in the arena
+    size_t size() const;
+
+};
+
+#endif
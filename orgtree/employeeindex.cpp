@@ -0,0 +1,153 @@
+#include "employeeindex.h"
+
+/**
+ * Index every employee of the organization chart under head, in one pass.
+ *
+ * <p>
+ * Walks the chart with an explicit stack, registering each employee in the hash
+ * and attaching the index to it, so that its future direct reports are indexed too.
+ * An employee that already belongs to another index stops the walk, and the employees
+ * attached so far are detached again, leaving the other index in charge of the chart.
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ */
+EmployeeIndex::EmployeeIndex(Employee* head)
+    : head(head), generation(0), attached(true), numAcquired(0), ownedByAcquirers(false) {
+
+    vector<Employee*> toVisit;
+    if (head != nullptr) {
+        toVisit.push_back(head);
+    }
+
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back();
+        toVisit.pop_back();
+
+        // The chart is indexed already, the employees attached so far had no index before
+        if (employee->index != nullptr) {
+            employees.forEach([](int e_id, Employee* employee) {
+                employee->index = nullptr;
+            });
+            employees = IdHashMap<Employee*>();
+            attached = false;
+            break;
+        }
+        add(employee);
+
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        toVisit.insert(toVisit.end(), directReports.begin(), directReports.end());
+    }
+
+    // Indexing the chart is not a change of it
+    generation = 0;
+}
+
+EmployeeIndex::~EmployeeIndex() {
+
+    // Deleted employees have already removed themselves, so every remaining node is alive
+    employees.forEach([this](int e_id, Employee* employee) {
+        if (employee->index == this) {
+            employee->index = nullptr;
+        }
+    });
+}
+
+void EmployeeIndex::add(Employee* employee) {
+    employee->index = this;
+    employees.put(employee->getEmployeeID(), employee);
+    generation++;
+}
+
+void EmployeeIndex::remove(Employee* employee) {
+    Employee** indexed = employees.find(employee->getEmployeeID());
+
+    // Only drop the entry if it still refers to this node
+    if (indexed != nullptr && *indexed == employee) {
+        employees.erase(employee->getEmployeeID());
+    }
+    employee->index = nullptr;
+    generation++;
+}
+
+int EmployeeIndex::size() const {
+    return (int)employees.size();
+}
+
+Employee* EmployeeIndex::getHead() const {
+    return head;
+}
+
+bool EmployeeIndex::isAttached() const {
+    return attached;
+}
+
+EmployeeIndex* EmployeeIndex::attachedTo(Employee* employee) {
+    return (employee == nullptr) ? nullptr : employee->index;
+}
+
+EmployeeIndex* EmployeeIndex::acquire(Employee* head) {
+    EmployeeIndex* index = attachedTo(head);
+    if (index == nullptr) {
+        index = new EmployeeIndex(head);
+        index->ownedByAcquirers = true;
+    }
+    index->numAcquired++;
+    return index;
+}
+
+void EmployeeIndex::release(EmployeeIndex* index) {
+    index->numAcquired--;
+    if (index->ownedByAcquirers && index->numAcquired == 0) {
+        delete index;
+    }
+}
+
+unsigned long long EmployeeIndex::getGeneration() const {
+    return generation;
+}
+
+/**
+ * Find the Employee node of an employee.
+ *
+ * @param  e_id the employee id being searched
+ * @return      the employee, nullptr if e_id is not present
+ */
+Employee* EmployeeIndex::findEmployee(int e_id) const {
+    Employee* const* employee = employees.find(e_id);
+    return (employee == nullptr) ? nullptr : *employee;
+}
+
+/**
+ * Check if an employee is present in the organization chart.
+ *
+ * @param  e_id the employee id being searched
+ * @return      true or false
+ */
+bool EmployeeIndex::isEmployeePresentInOrg(int e_id) const {
+    return employees.contains(e_id);
+}
+
+/**
+ * Find all managers of an employee.
+ *
+ * <p>
+ * Follows the manager links from the employee up to the head of the indexed chart.
+ *
+ * @param  e_id     the employee id being searched
+ * @param  managers a vector of ids of all managers in the ascending order
+ *                  of their tree height, from the direct manager to the head
+ * @return          is employee found
+ */
+bool EmployeeIndex::findManagersOfEmployee(int e_id, vector<int> &managers) const {
+
+    Employee* employee = findEmployee(e_id);
+    if (employee == nullptr) {
+        return false;
+    }
+
+    for (Employee* manager = employee; manager != head; ) {
+        manager = manager->getManager();
+        managers.push_back(manager->getEmployeeID());
+    }
+    return true;
+}
@@ -0,0 +1,112 @@
+#ifndef EMPLOYEEINDEX_H
+#define EMPLOYEEINDEX_H
+
+#include <vector>
+
+#include "orgtree.h"
+#include "idhashmap.h"
+
+using namespace std;
+
+// An index from employee ID to Employee node for one organization chart.
+//
+// Presence checks are O(1) hash lookups, and managers are found in O(level) by following
+// the manager links of the Employee nodes instead of searching the whole chart.
+//
+// The index keeps itself up to date: employees added to the chart through addDirectReport /
+// addDirectReports are indexed as they are created, and deleted employees are dropped from it.
+// Only one index can be attached to a chart at a time: an index built on a chart that is
+// indexed already stays empty and detached, see isAttached().
+//
+// Every employee added to or removed from the chart advances the index's generation, so a
+// result computed on the chart can be tagged with it and recognized as stale once it changes.
+class EmployeeIndex {
+
+private:
+    IdHashMap<Employee*> employees;
+    Employee* head;
+    unsigned long long generation;
+    bool attached;          // false if the chart had another index when this one was built
+    int numAcquired;        // acquire calls not yet released
+    bool ownedByAcquirers;  // created by acquire, and deleted by the last release
+
+    // Called by Employee as direct reports are created and deleted
+    friend class Employee;
+    void add(Employee* employee);
+    void remove(Employee* employee);
+
+public:
+    /**
+     * Index every employee of the organization chart under head, in one pass.
+     * If an employee of the chart already belongs to another index, the chart is left to that
+     * index, and this one stays empty with isAttached() false.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit EmployeeIndex(Employee* head);
+
+    // Detaches the index from the employees that are still alive and attached to it
+    ~EmployeeIndex();
+
+    EmployeeIndex(const EmployeeIndex &) = delete;
+    EmployeeIndex &operator=(const EmployeeIndex &) = delete;
+
+    // Number of employees in the chart
+    int size() const;
+
+    // The head of the indexed chart
+    Employee* getHead() const;
+
+    // Whether the index was attached to its chart, false if the chart had another index
+    bool isAttached() const;
+
+    // The index the employee's chart is attached to, nullptr if none
+    static EmployeeIndex* attachedTo(Employee* employee);
+
+    /**
+     * Share the index of a chart: the index already attached to head, or a new one that is
+     * deleted by the last release. An index created by its user must outlive everyone who
+     * acquired it.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     * @return      the index of the chart, to be handed back with release
+     */
+    static EmployeeIndex* acquire(Employee* head);
+
+    // Hand back an index returned by acquire
+    static void release(EmployeeIndex* index);
+
+    // Number of employees added to or removed from the chart since the index was built
+    unsigned long long getGeneration() const;
+
+    /**
+     * Find the Employee node of an employee. O(1)
+     *
+     * @param  e_id the employee id being searched
+     * @return      the employee, nullptr if e_id is not present
+     */
+    Employee* findEmployee(int e_id) const;
+
+    /**
+     * Check if an employee is present in the organization chart. O(1)
+     * Same result as Orgtree::isEmployeePresentInOrg on the indexed chart.
+     *
+     * @param  e_id the employee id being searched
+     * @return      true or false
+     */
+    bool isEmployeePresentInOrg(int e_id) const;
+
+    /**
+     * Find all managers of an employee. O(level of the employee)
+     * Same result as Orgtree::findManagersOfEmployee on the indexed chart.
+     *
+     * @param  e_id     the employee id being searched
+     * @param  managers a vector of ids of all managers in the ascending order
+     *                  of their tree height, from the direct manager to the head
+     * @return          is employee found
+     */
+    bool findManagersOfEmployee(int e_id, vector<int> &managers) const;
+
+};
+
+#endif
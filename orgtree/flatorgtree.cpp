@@ -0,0 +1,344 @@
+#include "flatorgtree.h"
+
+#include <algorithm>    // upper_bound
+
+const int FlatOrgtree::NO_INDEX;
+const int FlatOrgtree::KTH_MANAGER_WALK;
+
+/**
+ * Flatten the organization chart under head.
+ *
+ * <p>
+ * The tree is walked once in pre-order with an explicit stack, so deep charts cannot overflow
+ * the call stack. A second pass over the parent indices fills in the CSR direct report lists,
+ * and a backward pass adds up the subtree sizes that give each employee's subtree interval.
+ * Finally a counting sort by level lists the employees of every level in pre-order.
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ */
+FlatOrgtree::FlatOrgtree(Employee* head) {
+
+    childOffsets.push_back(0);
+
+    // An empty organization chart has no employees
+    if (head == nullptr) {
+        return;
+    }
+
+    // Each stack entry is an employee still to be numbered, together with its manager's index
+    vector<pair<Employee*, int> > toVisit;
+    toVisit.push_back(make_pair(head, NO_INDEX));
+
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back().first;
+        int parent = toVisit.back().second;
+        toVisit.pop_back();
+
+        // Number the employee with the next pre-order index
+        int index = (int)ids.size();
+        ids.push_back(employee->getEmployeeID());
+        parents.push_back(parent);
+        depths.push_back(parent == NO_INDEX ? 0 : depths[parent] + 1);
+        indexByID.put(employee->getEmployeeID(), index);
+
+        // Push the direct reports in reverse, so that the first one is visited next
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        childOffsets.push_back(childOffsets.back() + (int)directReports.size());
+        for (int i = (int)directReports.size() - 1; i >= 0; i--) {
+            toVisit.push_back(make_pair(directReports[i], index));
+        }
+    }
+
+    // Employees are numbered in pre-order, so each manager's direct reports come up in their original order
+    children.resize(childOffsets.back());
+    vector<int> nextChild(childOffsets.begin(), childOffsets.end() - 1);
+    for (int i = 1; i < (int)ids.size(); i++) {
+        children[nextChild[parents[i]]++] = i;
+    }
+
+    // Every employee comes after its manager, so a backward pass sees each subtree complete
+    // before adding its size to the manager's
+    vector<int> subtreeSizes(ids.size(), 1);
+    for (int i = (int)ids.size() - 1; i > 0; i--) {
+        subtreeSizes[parents[i]] += subtreeSizes[i];
+    }
+    subtreeEnds.resize(ids.size());
+    for (int i = 0; i < (int)ids.size(); i++) {
+        subtreeEnds[i] = i + subtreeSizes[i];
+    }
+
+    // Count the employees of every level, then place them in increasing index order
+    int numLevels = 1 + *max_element(depths.begin(), depths.end());
+    levelOffsets.assign(numLevels + 1, 0);
+    for (int i = 0; i < (int)ids.size(); i++) {
+        levelOffsets[depths[i] + 1]++;
+    }
+    for (int level = 0; level < numLevels; level++) {
+        levelOffsets[level + 1] += levelOffsets[level];
+    }
+    byLevel.resize(ids.size());
+    vector<int> nextAtLevel(levelOffsets.begin(), levelOffsets.end() - 1);
+    for (int i = 0; i < (int)ids.size(); i++) {
+        byLevel[nextAtLevel[depths[i]]++] = i;
+    }
+}
+
+int FlatOrgtree::size() const {
+    return (int)ids.size();
+}
+
+int FlatOrgtree::indexOf(int e_id) const {
+    const int* index = indexByID.find(e_id);
+    return (index == nullptr) ? NO_INDEX : *index;
+}
+
+int FlatOrgtree::getEmployeeID(int index) const {
+    return ids[index];
+}
+
+int FlatOrgtree::getManagerIndex(int index) const {
+    return parents[index];
+}
+
+int FlatOrgtree::getLevel(int index) const {
+    return depths[index];
+}
+
+int FlatOrgtree::getNumDirectReports(int index) const {
+    return childOffsets[index + 1] - childOffsets[index];
+}
+
+const int* FlatOrgtree::directReportsBegin(int index) const {
+    return children.data() + childOffsets[index];
+}
+
+const int* FlatOrgtree::directReportsEnd(int index) const {
+    return children.data() + childOffsets[index + 1];
+}
+
+int FlatOrgtree::getSubtreeEnd(int index) const {
+    return subtreeEnds[index];
+}
+
+const int* FlatOrgtree::subtreeIDsBegin(int index) const {
+    return ids.data() + index;
+}
+
+const int* FlatOrgtree::subtreeIDsEnd(int index) const {
+    return ids.data() + subtreeEnds[index];
+}
+
+/**
+ * Check if an employee is present in the organization chart.
+ *
+ * @param  e_id the employee id being searched
+ * @return      true or false
+ */
+bool FlatOrgtree::isEmployeePresentInOrg(int e_id) const {
+    return indexOf(e_id) != NO_INDEX;
+}
+
+/**
+ * Find all managers of an employee.
+ *
+ * <p>
+ * Walks up the parent indices from the employee to the head, which visits
+ * the managers in the same order as Orgtree::findManagersOfEmployee adds them.
+ *
+ * @param  e_id     the employee id being searched
+ * @param  managers a vector of ids of all managers in the ascending order
+ *                  of their tree height, from the direct manager to the head
+ * @return          is employee found
+ */
+bool FlatOrgtree::findManagersOfEmployee(int e_id, vector<int> &managers) const {
+
+    int index = indexOf(e_id);
+    if (index == NO_INDEX) {
+        return false;
+    }
+
+    for (int manager = parents[index]; manager != NO_INDEX; manager = parents[manager]) {
+        managers.push_back(ids[manager]);
+    }
+    return true;
+}
+
+FlatOrgtree::ManagerChain FlatOrgtree::getManagerChain(int e_id) const {
+    int index = indexOf(e_id);
+    return ManagerChain(this, (index == NO_INDEX) ? NO_INDEX : parents[index]);
+}
+
+/**
+ * Find the k-th manager of an employee.
+ *
+ * <p>
+ * The k-th manager is the manager at level depth - k, and among the employees of that level
+ * it is the last one numbered at most the employee's index: any later one would have to be
+ * under the manager too, which is impossible at the manager's own level.
+ *
+ * @param  e_id the employee id being searched
+ * @param  k    how many levels up to go, at least 1
+ * @return      employee ID of the k-th manager of e
+ *              returns Employee::NOT_FOUND if e_id is not present or has fewer than k managers
+ */
+int FlatOrgtree::findKthManager(int e_id, int k) const {
+    int index = indexOf(e_id);
+    if (index == NO_INDEX || k < 1 || k > depths[index]) {
+        return Employee::NOT_FOUND;
+    }
+
+    // A few parent steps cost fewer cache misses than a binary search over a wide level
+    if (k <= KTH_MANAGER_WALK) {
+        for (int i = 0; i < k; i++) {
+            index = parents[index];
+        }
+        return ids[index];
+    }
+
+    int level = depths[index] - k;
+    const int* levelEnd = byLevel.data() + levelOffsets[level + 1];
+    const int* manager = upper_bound(byLevel.data() + levelOffsets[level], levelEnd, index) - 1;
+    return ids[*manager];
+}
+
+/**
+ * Find the level of an employee in the organization chart.
+ *
+ * @param  e_id      the employee id being searched
+ * @param  headLevel the level of the head employee of the organization
+ * @return  level of the employee in the org chart
+ *          returns Employee::NOT_FOUND if e_id is not present
+ */
+int FlatOrgtree::findEmployeeLevel(int e_id, int headLevel) const {
+
+    int index = indexOf(e_id);
+    if (index == NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+    return headLevel + depths[index];
+}
+
+/**
+ * Find the closest shared manager (lowest common ancestor) of two present employees,
+ * by lifting the deeper employee to the level of the other and then lifting both together.
+ */
+int FlatOrgtree::findClosestSharedManagerIndex(int e1_index, int e2_index) const {
+
+    while (depths[e1_index] > depths[e2_index]) {
+        e1_index = parents[e1_index];
+    }
+    while (depths[e2_index] > depths[e1_index]) {
+        e2_index = parents[e2_index];
+    }
+    while (e1_index != e2_index) {
+        e1_index = parents[e1_index];
+        e2_index = parents[e2_index];
+    }
+    return e1_index;
+}
+
+/**
+ * Find the closest shared manager of two employees e1 and e2.
+ *
+ * @param  e1_id id of employee 1 being searched
+ * @param  e2_id id of employee 2 being searched
+ * @return   employee ID of the closest shared manager of e1 and e2
+ *           if neither e1 or e2 is present, returns Employee::NOT_FOUND
+ *           if only one of e1 and e2 is present, returns the one that is present
+ */
+int FlatOrgtree::findClosestSharedManager(int e1_id, int e2_id) const {
+
+    int e1_index = indexOf(e1_id);
+    int e2_index = indexOf(e2_id);
+
+    if (e1_index == NO_INDEX && e2_index == NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+    if (e2_index == NO_INDEX) {
+        return e1_id;
+    }
+    if (e1_index == NO_INDEX) {
+        return e2_id;
+    }
+    return ids[findClosestSharedManagerIndex(e1_index, e2_index)];
+}
+
+/**
+ * Calculate the number of managers between employee e1 and employee e2.
+ *
+ * <p>
+ * number of edges between e1 and closest shared manager +
+ * number of edges between e2 and closest shared manager - 1
+ *
+ * @param  e1_id id of employee 1 being searched
+ * @param  e2_id id of employee 2 being searched
+ * @return   number of managers between employee e1 and employee e2
+ *           returns Employee::NOT_FOUND if either e1 or e2 is not present in the chart
+ */
+int FlatOrgtree::findNumOfManagersBetween(int e1_id, int e2_id) const {
+
+    int e1_index = indexOf(e1_id);
+    int e2_index = indexOf(e2_id);
+
+    if (e1_index == NO_INDEX || e2_index == NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+
+    int sharedManager = findClosestSharedManagerIndex(e1_index, e2_index);
+    return (depths[e1_index] - depths[sharedManager]) +
+           (depths[e2_index] - depths[sharedManager]) - 1;
+}
+
+/**
+ * Check if employee m is a manager of employee e, directly or further up the chart.
+ *
+ * <p>
+ * m is a manager of e exactly when e is numbered inside m's subtree interval, after m itself.
+ *
+ * @param  m_id id of the possible manager
+ * @param  e_id id of the employee
+ * @return   true if both are present and m is a manager of e, false otherwise
+ */
+bool FlatOrgtree::isManagerOf(int m_id, int e_id) const {
+
+    int m_index = indexOf(m_id);
+    int e_index = indexOf(e_id);
+
+    if (m_index == NO_INDEX || e_index == NO_INDEX) {
+        return false;
+    }
+    return m_index < e_index && e_index < subtreeEnds[m_index];
+}
+
+/**
+ * Count the employees that roll up to an employee, directly or indirectly.
+ *
+ * @param  e_id id of the employee
+ * @return   number of employees under e, not counting e itself
+ *           returns Employee::NOT_FOUND if e_id is not present in the chart
+ */
+int FlatOrgtree::findNumOfEmployeesUnder(int e_id) const {
+
+    int index = indexOf(e_id);
+    if (index == NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+    return subtreeEnds[index] - index - 1;
+}
+
+/**
+ * List the employees that roll up to an employee, directly or indirectly.
+ *
+ * @param  e_id      id of the employee
+ * @param  employees ids of everyone under e in pre-order, not including e itself
+ * @return           is employee found
+ */
+bool FlatOrgtree::findEmployeesUnder(int e_id, vector<int> &employees) const {
+
+    int index = indexOf(e_id);
+    if (index == NO_INDEX) {
+        return false;
+    }
+    employees.insert(employees.end(), subtreeIDsBegin(index) + 1, subtreeIDsEnd(index));
+    return true;
+}
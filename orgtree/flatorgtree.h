@@ -0,0 +1,259 @@
+#ifndef FLATORGTREE_H
+#define FLATORGTREE_H
+
+#include <iterator>
+#include <stddef.h>
+#include <vector>
+
+#include "orgtree.h"
+#include "idhashmap.h"
+
+using namespace std;
+
+// A read-only, cache friendly copy of an organization chart.
+//
+// Employees are numbered 0 .. size() - 1 in depth-first pre-order (the head is 0),
+// and every per-employee attribute lives in its own contiguous array indexed by that number.
+// Direct reports are stored in compressed sparse row (CSR) form: the direct reports of
+// employee i are children[childOffsets[i]] .. children[childOffsets[i + 1] - 1], in the same
+// order as in the original Employee tree.
+//
+// Pre-order numbering also gives every employee an interval: employee i is entered at i and
+// its subtree is left at subtreeEnds[i], so everyone who rolls up to employee i is numbered
+// i + 1 .. subtreeEnds[i] - 1. Manager checks are interval containment, headcounts are
+// interval lengths, and everyone under an employee is one contiguous slice of the IDs.
+//
+// The manager of employee i at level d is the last employee at level d numbered at most i,
+// so with the employees of every level listed in pre-order, the k-th manager of an employee
+// is one binary search away.
+//
+// The flat tree is a snapshot: it does not follow later changes made to the Employee tree.
+class FlatOrgtree {
+
+private:
+    vector<int> ids;            // employee IDs, in pre-order
+    vector<int> parents;        // index of each employee's direct manager, NO_INDEX for the head
+    vector<int> depths;         // level of each employee, the head has a level of 0
+    vector<int> childOffsets;   // size() + 1 offsets into children
+    vector<int> children;       // indices of the direct reports of every employee
+    vector<int> subtreeEnds;    // one past the last index in the subtree of each employee
+    vector<int> levelOffsets;   // start in byLevel of every level, then size()
+    vector<int> byLevel;        // indices of the employees of every level, in pre-order
+    IdHashMap<int> indexByID;   // employee ID to index
+
+    // findKthManager follows the parent indices for k up to this, and binary searches beyond
+    static const int KTH_MANAGER_WALK = 8;
+
+    int findClosestSharedManagerIndex(int e1_index, int e2_index) const;
+
+public:
+    // Index of a missing employee, and the parent index of the head
+    static const int NO_INDEX = -1;
+
+    // A view of the managers of an employee, from the direct manager up to the head.
+    // Iterating follows the parent indices one step per increment and yields employee IDs,
+    // so it allocates nothing and a search can stop at the first manager it is after.
+    // The view is valid as long as the FlatOrgtree it came from.
+    class ManagerChain {
+
+    public:
+        class const_iterator {
+
+        private:
+            const FlatOrgtree* org;
+            int index;
+
+        public:
+            typedef forward_iterator_tag iterator_category;
+            typedef int value_type;
+            typedef ptrdiff_t difference_type;
+            typedef const int* pointer;
+            typedef const int& reference;
+
+            const_iterator(const FlatOrgtree* org, int index) : org(org), index(index) {}
+
+            // Employee ID of the current manager
+            const int& operator*() const {
+                return org->ids[index];
+            }
+
+            // Index of the current manager
+            int getIndex() const {
+                return index;
+            }
+
+            const_iterator& operator++() {
+                index = org->parents[index];
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator previous = *this;
+                index = org->parents[index];
+                return previous;
+            }
+
+            bool operator==(const const_iterator &other) const {
+                return index == other.index;
+            }
+
+            bool operator!=(const const_iterator &other) const {
+                return index != other.index;
+            }
+        };
+
+        ManagerChain(const FlatOrgtree* org, int firstIndex) : org(org), firstIndex(firstIndex) {}
+
+        const_iterator begin() const {
+            return const_iterator(org, firstIndex);
+        }
+
+        const_iterator end() const {
+            return const_iterator(org, NO_INDEX);
+        }
+
+        bool empty() const {
+            return firstIndex == NO_INDEX;
+        }
+
+    private:
+        const FlatOrgtree* org;
+        int firstIndex;     // index of the direct manager, NO_INDEX for an empty chain
+    };
+
+    /**
+     * Flatten the organization chart under head.
+     * The Employee tree is only read, and it can be deleted once the flat tree is built.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit FlatOrgtree(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    // Index of employee e_id, NO_INDEX if e_id is not present
+    int indexOf(int e_id) const;
+
+    // Accessors by index, 0 <= index < size()
+    int getEmployeeID(int index) const;
+    int getManagerIndex(int index) const;
+    int getLevel(int index) const;
+    int getNumDirectReports(int index) const;
+    const int* directReportsBegin(int index) const;
+    const int* directReportsEnd(int index) const;
+    int getSubtreeEnd(int index) const;
+
+    // Employee IDs of the subtree of employee index in pre-order, the employee itself first
+    const int* subtreeIDsBegin(int index) const;
+    const int* subtreeIDsEnd(int index) const;
+
+    /**
+     * Check if an employee is present in the organization chart. O(1)
+     * Same result as Orgtree::isEmployeePresentInOrg on the original tree.
+     *
+     * @param  e_id the employee id being searched
+     * @return      true or false
+     */
+    bool isEmployeePresentInOrg(int e_id) const;
+
+    /**
+     * Find all managers of an employee. O(level of the employee)
+     * Same result as Orgtree::findManagersOfEmployee on the original tree.
+     *
+     * @param  e_id     the employee id being searched
+     * @param  managers a vector of ids of all managers in the ascending order
+     *                  of their tree height, from the direct manager to the head
+     * @return          is employee found
+     */
+    bool findManagersOfEmployee(int e_id, vector<int> &managers) const;
+
+    /**
+     * View the managers of an employee without copying them. O(1)
+     * Iterating it yields the same IDs, in the same order, as findManagersOfEmployee.
+     *
+     * @param  e_id the employee id being searched
+     * @return      the managers of e, from the direct manager to the head,
+     *              an empty chain if e_id is the head or is not present
+     */
+    ManagerChain getManagerChain(int e_id) const;
+
+    /**
+     * Find the k-th manager of an employee: its direct manager for k = 1, their manager
+     * for k = 2, and so on. O(log N)
+     * Same as the k-th ID found by findManagersOfEmployee.
+     *
+     * @param  e_id the employee id being searched
+     * @param  k    how many levels up to go, at least 1
+     * @return      employee ID of the k-th manager of e
+     *              returns Employee::NOT_FOUND if e_id is not present or has fewer than k managers
+     */
+    int findKthManager(int e_id, int k) const;
+
+    /**
+     * Find the level of an employee in the organization chart. O(1)
+     * Same result as Orgtree::findEmployeeLevel on the original tree.
+     *
+     * @param  e_id      the employee id being searched
+     * @param  headLevel the level of the head employee of the organization
+     * @return  level of the employee in the org chart
+     *          returns Employee::NOT_FOUND if e_id is not present
+     */
+    int findEmployeeLevel(int e_id, int headLevel) const;
+
+    /**
+     * Find the closest shared manager of two employees e1 and e2. O(level of e1 and e2)
+     * Same result as Orgtree::findClosestSharedManager on the original tree.
+     *
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   employee ID of the closest shared manager of e1 and e2
+     *           if neither e1 or e2 is present, returns Employee::NOT_FOUND
+     *           if only one of e1 and e2 is present, returns the one that is present
+     */
+    int findClosestSharedManager(int e1_id, int e2_id) const;
+
+    /**
+     * Calculate the number of managers between employee e1 and employee e2. O(level of e1 and e2)
+     * Same result as Orgtree::findNumOfManagersBetween on the original tree.
+     *
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   number of managers between employee e1 and employee e2
+     *           returns Employee::NOT_FOUND if either e1 or e2 is not present in the chart
+     */
+    int findNumOfManagersBetween(int e1_id, int e2_id) const;
+
+    /**
+     * Check if employee m is a manager of employee e, directly or further up the chart. O(1)
+     * Same as m_id being one of the managers found by findManagersOfEmployee(e_id).
+     *
+     * @param  m_id id of the possible manager
+     * @param  e_id id of the employee
+     * @return   true if both are present and m is a manager of e,
+     *           false otherwise, including when m_id and e_id are the same employee
+     */
+    bool isManagerOf(int m_id, int e_id) const;
+
+    /**
+     * Count the employees that roll up to an employee, directly or indirectly. O(1)
+     *
+     * @param  e_id id of the employee
+     * @return   number of employees under e, not counting e itself
+     *           returns Employee::NOT_FOUND if e_id is not present in the chart
+     */
+    int findNumOfEmployeesUnder(int e_id) const;
+
+    /**
+     * List the employees that roll up to an employee, directly or indirectly.
+     * Copies one contiguous slice of the pre-order IDs.
+     *
+     * @param  e_id      id of the employee
+     * @param  employees ids of everyone under e in pre-order, not including e itself
+     * @return           is employee found
+     */
+    bool findEmployeesUnder(int e_id, vector<int> &employees) const;
+
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef IDHASHMAP_H
+#define IDHASHMAP_H
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+// An open-addressing hash map from employee ID to a value.
+//
+// All entries live in one flat array of slots and collisions are resolved by linear probing,
+// so a lookup usually touches a single cache line instead of chasing a bucket list.
+// The table is kept at most half full, and erase shifts the following entries back
+// instead of leaving tombstones, so lookups stay short after many erases.
+//
+// INT_MIN marks an empty slot. An entry with INT_MIN as its key is kept outside the slots,
+// so every int is a valid employee ID.
+template <typename V>
+class IdHashMap {
+
+private:
+    struct Slot {
+        int key;
+        V value;
+    };
+
+    vector<Slot> slots;     // power of two number of slots
+    size_t count;           // number of entries, including the EMPTY_KEY entry
+    bool hasEmptyKey;       // whether EMPTY_KEY is present, with its value in emptyKeyValue
+    V emptyKeyValue;
+    int shift;              // 64 - log2(number of slots)
+
+    // Fibonacci hashing: the top bits of the product are well mixed, even for sequential IDs
+    size_t home(int key) const {
+        return (size_t)(((uint64_t)(uint32_t)key * 11400714819323198485ULL) >> shift);
+    }
+
+    size_t mask() const {
+        return slots.size() - 1;
+    }
+
+    // Index of key's slot, or of the empty slot where key would be inserted
+    size_t probe(int key) const {
+        size_t i = home(key);
+        while (slots[i].key != EMPTY_KEY && slots[i].key != key) {
+            i = (i + 1) & mask();
+        }
+        return i;
+    }
+
+    void rehash(size_t numSlots) {
+        vector<Slot> old;
+        old.swap(slots);
+
+        Slot empty;
+        empty.key = EMPTY_KEY;
+        empty.value = V();
+        slots.assign(numSlots, empty);
+        shift = 64;
+        for (size_t n = numSlots; n > 1; n /= 2) {
+            shift--;
+        }
+
+        for (size_t i = 0; i < old.size(); i++) {
+            if (old[i].key != EMPTY_KEY) {
+                slots[probe(old[i].key)] = old[i];
+            }
+        }
+    }
+
+public:
+    static const int EMPTY_KEY = INT_MIN;
+
+    IdHashMap() : count(0), hasEmptyKey(false), emptyKeyValue(), shift(0) {
+        rehash(16);
+    }
+
+    // Make room for numEntries entries without rehashing
+    void reserve(size_t numEntries) {
+        size_t numSlots = slots.size();
+        while (numSlots < 2 * numEntries) {
+            numSlots *= 2;
+        }
+        if (numSlots != slots.size()) {
+            rehash(numSlots);
+        }
+    }
+
+    // Insert key, or replace its value if it is already present
+    void put(int key, const V &value) {
+        if (key == EMPTY_KEY) {
+            count += hasEmptyKey ? 0 : 1;
+            hasEmptyKey = true;
+            emptyKeyValue = value;
+            return;
+        }
+        if (2 * (count + 1) > slots.size()) {
+            rehash(2 * slots.size());
+        }
+        size_t i = probe(key);
+        if (slots[i].key == EMPTY_KEY) {
+            slots[i].key = key;
+            count++;
+        }
+        slots[i].value = value;
+    }
+
+    // Pointer to key's value, nullptr if key is not present
+    const V* find(int key) const {
+        if (key == EMPTY_KEY) {
+            return hasEmptyKey ? &emptyKeyValue : nullptr;
+        }
+        const Slot &slot = slots[probe(key)];
+        return (slot.key == EMPTY_KEY) ? nullptr : &slot.value;
+    }
+
+    V* find(int key) {
+        if (key == EMPTY_KEY) {
+            return hasEmptyKey ? &emptyKeyValue : nullptr;
+        }
+        Slot &slot = slots[probe(key)];
+        return (slot.key == EMPTY_KEY) ? nullptr : &slot.value;
+    }
+
+    bool contains(int key) const {
+        return find(key) != nullptr;
+    }
+
+    // Remove key if it is present, returns whether it was
+    bool erase(int key) {
+        if (key == EMPTY_KEY) {
+            if (!hasEmptyKey) {
+                return false;
+            }
+            hasEmptyKey = false;
+            emptyKeyValue = V();
+            count--;
+            return true;
+        }
+        size_t hole = probe(key);
+        if (slots[hole].key == EMPTY_KEY) {
+            return false;
+        }
+
+        // Shift back every following entry whose home slot is at or before the hole
+        for (size_t next = (hole + 1) & mask(); slots[next].key != EMPTY_KEY; next = (next + 1) & mask()) {
+            size_t nextHome = home(slots[next].key);
+            if (((next - nextHome) & mask()) >= ((next - hole) & mask())) {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+        slots[hole].key = EMPTY_KEY;
+        slots[hole].value = V();
+        count--;
+        return true;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // Call visit(key, value) for every entry, in no particular order
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        if (hasEmptyKey) {
+            visit((int)EMPTY_KEY, emptyKeyValue);
+        }
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].key != EMPTY_KEY) {
+                visit(slots[i].key, slots[i].value);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "orgbatchquery.h"
+
+#include <algorithm>   // min
+#include <functional>  // ref, cref
+#include <thread>
+
+/**
+ * Answer pairs[first .. last - 1] with one sweep over the chart.
+ *
+ * <p>
+ * Employees are numbered in pre-order, so an employee has been visited exactly when its
+ * index is smaller than the current one. The stack of open employees is the management
+ * chain of the current employee; whenever the sweep leaves a subtree, the finished employee
+ * is merged into its manager's set, and find() returns the closest open manager.
+ *
+ * @param  org         the flattened organization chart
+ * @param  pairs       (e1_id, e2_id) pairs of employee ids
+ * @param  first       first pair of the block
+ * @param  last        one past the last pair of the block
+ * @param  numManagers results, indexed like pairs
+ */
+void OrgBatchQuery::answerBlock(const FlatOrgtree &org, const vector<pair<int, int> > &pairs,
+                                size_t first, size_t last, vector<int> &numManagers) {
+
+    int n = org.size();
+    vector<int> e1_index(last - first), e2_index(last - first);
+
+    // Bucket the pairs by employee: pairs of employee i are pairsAt[pairOffsets[i] .. pairOffsets[i + 1] - 1]
+    vector<int> pairOffsets(n + 1, 0);
+    for (size_t q = first; q < last; q++) {
+        e1_index[q - first] = org.indexOf(pairs[q].first);
+        e2_index[q - first] = org.indexOf(pairs[q].second);
+        if (e1_index[q - first] == FlatOrgtree::NO_INDEX || e2_index[q - first] == FlatOrgtree::NO_INDEX) {
+            numManagers[q] = Employee::NOT_FOUND;
+            continue;
+        }
+        pairOffsets[e1_index[q - first] + 1]++;
+        pairOffsets[e2_index[q - first] + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        pairOffsets[i + 1] += pairOffsets[i];
+    }
+    vector<int> pairsAt(pairOffsets[n]);
+    vector<int> nextPair(pairOffsets.begin(), pairOffsets.end() - 1);
+    for (size_t q = first; q < last; q++) {
+        if (e1_index[q - first] != FlatOrgtree::NO_INDEX && e2_index[q - first] != FlatOrgtree::NO_INDEX) {
+            pairsAt[nextPair[e1_index[q - first]]++] = (int)(q - first);
+            pairsAt[nextPair[e2_index[q - first]]++] = (int)(q - first);
+        }
+    }
+
+    // Union-find over employees, every employee starts in its own set
+    vector<int> sets(n);
+    for (int i = 0; i < n; i++) {
+        sets[i] = i;
+    }
+    vector<int> open;
+
+    for (int i = 0; i < n; i++) {
+
+        // Close the subtrees that end before employee i, merging each into its manager's set
+        while (!open.empty() && open.back() != org.getManagerIndex(i)) {
+            sets[open.back()] = org.getManagerIndex(open.back());
+            open.pop_back();
+        }
+        open.push_back(i);
+
+        for (int p = pairOffsets[i]; p < pairOffsets[i + 1]; p++) {
+            int q = pairsAt[p];
+            int other = (e1_index[q] == i) ? e2_index[q] : e1_index[q];
+
+            // Only answer once both employees of the pair have been visited
+            if (other > i) {
+                continue;
+            }
+
+            // Find the closest open manager of the other employee, compressing the path behind us
+            int sharedManager = other;
+            while (sets[sharedManager] != sharedManager) {
+                sharedManager = sets[sharedManager];
+            }
+            for (int e = other; sets[e] != sharedManager; ) {
+                int next = sets[e];
+                sets[e] = sharedManager;
+                e = next;
+            }
+
+            numManagers[first + q] = (org.getLevel(i) - org.getLevel(sharedManager)) +
+                                     (org.getLevel(other) - org.getLevel(sharedManager)) - 1;
+        }
+    }
+}
+
+/**
+ * Calculate the number of managers between every pair of employees (e1, e2).
+ *
+ * @param  org        the flattened organization chart
+ * @param  pairs      (e1_id, e2_id) pairs of employee ids
+ * @param  numThreads number of threads to split the pairs over, 0 to use one per core
+ * @return   number of managers between e1 and e2 for every pair, in the order of pairs,
+ *           Employee::NOT_FOUND for pairs where e1 or e2 is not present in the chart
+ */
+vector<int> OrgBatchQuery::findNumOfManagersBetween(const FlatOrgtree &org, const vector<pair<int, int> > &pairs,
+                                                    int numThreads) {
+
+    vector<int> numManagers(pairs.size(), Employee::NOT_FOUND);
+
+    if (numThreads <= 0) {
+        numThreads = (int)thread::hardware_concurrency();
+    }
+    if (numThreads <= 0) {
+        numThreads = 1;
+    }
+    if ((size_t)numThreads > pairs.size()) {
+        numThreads = pairs.size() > 0 ? (int)pairs.size() : 1;
+    }
+
+    // Every thread writes only the results of its own block of pairs
+    size_t blockSize = (pairs.size() + numThreads - 1) / numThreads;
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) {
+        size_t first = t * blockSize;
+        size_t last = min(pairs.size(), first + blockSize);
+        if (first < last) {
+            workers.push_back(thread(answerBlock, cref(org), cref(pairs), first, last, ref(numManagers)));
+        }
+    }
+    answerBlock(org, pairs, 0, min(pairs.size(), blockSize), numManagers);
+
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    return numManagers;
+}
+
+vector<int> OrgBatchQuery::findNumOfManagersBetween(Employee* head, const vector<pair<int, int> > &pairs,
+                                                    int numThreads) {
+    FlatOrgtree org(head);
+    return findNumOfManagersBetween(org, pairs, numThreads);
+}
@@ -0,0 +1,56 @@
+#ifndef ORGBATCHQUERY_H
+#define ORGBATCHQUERY_H
+
+#include <utility>
+#include <vector>
+
+#include "orgtree.h"
+#include "flatorgtree.h"
+
+using namespace std;
+
+// Offline batch queries over a whole organization chart.
+//
+// Instead of answering employee pairs one at a time, all pairs are collected first and
+// answered together in one pre-order sweep over a FlatOrgtree with Tarjan's offline lowest
+// common ancestor algorithm: employees whose subtree is finished are merged into their
+// manager's union-find set, so when the sweep reaches the second employee of a pair,
+// the set holding the first employee is owned by their closest shared manager.
+//
+// The pairs are split into contiguous blocks, one per thread. Every thread sweeps the
+// chart for its own block, so a batch costs O(threads * N + Q) in total, and the results
+// come back in the order of the input pairs.
+class OrgBatchQuery {
+
+private:
+    static void answerBlock(const FlatOrgtree &org, const vector<pair<int, int> > &pairs,
+                            size_t first, size_t last, vector<int> &numManagers);
+
+public:
+    /**
+     * Calculate the number of managers between every pair of employees (e1, e2).
+     * Each result is the same as Orgtree::findNumOfManagersBetween(head, e1, e2).
+     *
+     * @param  org        the flattened organization chart
+     * @param  pairs      (e1_id, e2_id) pairs of employee ids
+     * @param  numThreads number of threads to split the pairs over, 0 to use one per core
+     * @return   number of managers between e1 and e2 for every pair, in the order of pairs,
+     *           Employee::NOT_FOUND for pairs where e1 or e2 is not present in the chart
+     */
+    static vector<int> findNumOfManagersBetween(const FlatOrgtree &org, const vector<pair<int, int> > &pairs,
+                                                int numThreads);
+
+    /**
+     * Same as above, flattening the organization chart under head first.
+     *
+     * @param  head       the head / root Employee of the organization chart
+     * @param  pairs      (e1_id, e2_id) pairs of employee ids
+     * @param  numThreads number of threads to split the pairs over, 0 to use one per core
+     * @return   number of managers between e1 and e2 for every pair, in the order of pairs
+     */
+    static vector<int> findNumOfManagersBetween(Employee* head, const vector<pair<int, int> > &pairs,
+                                                int numThreads);
+
+};
+
+#endif
@@ -0,0 +1,137 @@
+#include "orglcaindex.h"
+
+#include <utility>  // std::move, std::swap
+
+/**
+ * Preprocess the organization chart under head.
+ *
+ * <p>
+ * One pre-order walk with an explicit stack records every employee's position,
+ * manager and level, then level k of the sparse table is filled from level k - 1.
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ */
+OrgLcaIndex::OrgLcaIndex(Employee* head) {
+
+    vector<pair<Employee*, int> > toVisit;
+    if (head != nullptr) {
+        toVisit.push_back(make_pair(head, -1));
+    }
+
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back().first;
+        int parent = toVisit.back().second;
+        toVisit.pop_back();
+
+        int position = (int)employees.size();
+        employees.push_back(employee);
+        parents.push_back(parent);
+        depths.push_back(parent == -1 ? 0 : depths[parent] + 1);
+        positions.put(employee->getEmployeeID(), position);
+
+        // Push the direct reports in reverse, so that the first one is visited next
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (int i = (int)directReports.size() - 1; i >= 0; i--) {
+            toVisit.push_back(make_pair(directReports[i], position));
+        }
+    }
+
+    // Level 0 covers single positions, level k combines two halves from level k - 1
+    int n = (int)employees.size();
+    sparseTable.push_back(vector<int>(n));
+    for (int i = 0; i < n; i++) {
+        sparseTable[0][i] = i;
+    }
+    for (int k = 1; (1 << k) <= n; k++) {
+        const vector<int> &previous = sparseTable[k - 1];
+        vector<int> level(n - (1 << k) + 1);
+        for (int i = 0; i < (int)level.size(); i++) {
+            int left = previous[i];
+            int right = previous[i + (1 << (k - 1))];
+            level[i] = (depths[right] < depths[left]) ? right : left;
+        }
+        sparseTable.push_back(std::move(level));
+    }
+}
+
+int OrgLcaIndex::size() const {
+    return (int)employees.size();
+}
+
+int OrgLcaIndex::positionOf(int e_id) const {
+    const int* position = positions.find(e_id);
+    return (position == nullptr) ? -1 : *position;
+}
+
+/**
+ * Position of the highest-ranking (lowest level) employee in positions first .. last,
+ * from the two overlapping sparse table ranges that cover them.
+ */
+int OrgLcaIndex::highestRanking(int first, int last) const {
+    int k = 31 - __builtin_clz((unsigned)(last - first + 1));
+    int left = sparseTable[k][first];
+    int right = sparseTable[k][last - (1 << k) + 1];
+    return (depths[right] < depths[left]) ? right : left;
+}
+
+int OrgLcaIndex::closestSharedManagerPosition(int e1_pos, int e2_pos) const {
+    if (e1_pos == e2_pos) {
+        return e1_pos;
+    }
+    if (e1_pos > e2_pos) {
+        swap(e1_pos, e2_pos);
+    }
+    return parents[highestRanking(e1_pos + 1, e2_pos)];
+}
+
+/**
+ * Find the closest shared manager of two employees e1 and e2.
+ *
+ * @param  e1_id id of employee 1 being searched
+ * @param  e2_id id of employee 2 being searched
+ * @return   closest shared manager in the org chart between employee e1 and employee e2
+ *           if the chart is empty or neither e1 or e2 is present, returns nullptr
+ *           if only one of e1 and e2 is present, returns the one that is present
+ */
+Employee* OrgLcaIndex::findClosestSharedManager(int e1_id, int e2_id) const {
+
+    int e1_pos = positionOf(e1_id);
+    int e2_pos = positionOf(e2_id);
+
+    if (e1_pos == -1 && e2_pos == -1) {
+        return nullptr;
+    }
+    if (e2_pos == -1) {
+        return employees[e1_pos];
+    }
+    if (e1_pos == -1) {
+        return employees[e2_pos];
+    }
+    return employees[closestSharedManagerPosition(e1_pos, e2_pos)];
+}
+
+/**
+ * Calculate the number of managers between employee e1 and employee e2.
+ *
+ * <p>
+ * number of edges between e1 and closest shared manager +
+ * number of edges between e2 and closest shared manager - 1
+ *
+ * @param  e1_id id of employee 1 being searched
+ * @param  e2_id id of employee 2 being searched
+ * @return   number of managers between employee e1 and employee e2
+ *           returns Employee::NOT_FOUND if either e1 or e2 is not present in the chart
+ */
+int OrgLcaIndex::findNumOfManagersBetween(int e1_id, int e2_id) const {
+
+    int e1_pos = positionOf(e1_id);
+    int e2_pos = positionOf(e2_id);
+
+    if (e1_pos == -1 || e2_pos == -1) {
+        return Employee::NOT_FOUND;
+    }
+
+    int sharedManager = closestSharedManagerPosition(e1_pos, e2_pos);
+    return (depths[e1_pos] - depths[sharedManager]) +
+           (depths[e2_pos] - depths[sharedManager]) - 1;
+}
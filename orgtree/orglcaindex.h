@@ -0,0 +1,69 @@
+#ifndef ORGLCAINDEX_H
+#define ORGLCAINDEX_H
+
+#include <vector>
+
+#include "orgtree.h"
+#include "idhashmap.h"
+
+using namespace std;
+
+// A preprocessed index answering closest shared manager (lowest common ancestor) queries in O(1).
+//
+// Building the index walks the chart once in depth-first pre-order and builds a sparse table
+// of range minimum levels over that order, which takes O(N log N) time and memory.
+// For two different employees u and v with pre-order positions pos(u) < pos(v), the
+// highest-ranking employee in positions pos(u) + 1 .. pos(v) is a direct report of their
+// closest shared manager, so one range minimum query answers the closest shared manager.
+//
+// The index is a snapshot of the chart: it has to be rebuilt after the chart changes.
+class OrgLcaIndex {
+
+private:
+    vector<Employee*> employees;    // employees in pre-order
+    vector<int> parents;            // pre-order position of each employee's manager, -1 for the head
+    vector<int> depths;             // level of each employee, the head has a level of 0
+    vector<vector<int> > sparseTable;   // sparseTable[k][i]: highest-ranking employee in positions i .. i + 2^k - 1
+    IdHashMap<int> positions;       // employee ID to pre-order position
+
+    int positionOf(int e_id) const;
+    int highestRanking(int first, int last) const;
+    int closestSharedManagerPosition(int e1_pos, int e2_pos) const;
+
+public:
+    /**
+     * Preprocess the organization chart under head.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit OrgLcaIndex(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    /**
+     * Find the closest shared manager of two employees e1 and e2. O(1)
+     * Same result as Orgtree::findClosestSharedManager on the preprocessed chart.
+     *
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   closest shared manager in the org chart between employee e1 and employee e2
+     *           if the chart is empty or neither e1 or e2 is present, returns nullptr
+     *           if only one of e1 and e2 is present, returns the one that is present
+     */
+    Employee* findClosestSharedManager(int e1_id, int e2_id) const;
+
+    /**
+     * Calculate the number of managers between employee e1 and employee e2. O(1)
+     * Same result as Orgtree::findNumOfManagersBetween on the preprocessed chart.
+     *
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   number of managers between employee e1 and employee e2
+     *           returns Employee::NOT_FOUND if either e1 or e2 is not present in the chart
+     */
+    int findNumOfManagersBetween(int e1_id, int e2_id) const;
+
+};
+
+#endif
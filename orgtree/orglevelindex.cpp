@@ -0,0 +1,102 @@
+#include "orglevelindex.h"
+
+/**
+ * Preprocess the organization chart under head.
+ *
+ * <p>
+ * The employees of level k are walked in order and their direct reports collected as
+ * level k + 1, so the IDs of level k + 1 are appended right after those of level k.
+ * The level of every ID is filled in from the level offsets afterwards.
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ */
+OrgLevelIndex::OrgLevelIndex(Employee* head) {
+    levelOffsets.push_back(0);
+    if (head == nullptr) {
+        return;
+    }
+
+    vector<Employee*> level(1, head);
+    vector<Employee*> nextLevel;
+    while (!level.empty()) {
+        for (size_t i = 0; i < level.size(); i++) {
+            ids.push_back(level[i]->getEmployeeID());
+
+            const vector<Employee*> &directReports = level[i]->getDirectReports();
+            nextLevel.insert(nextLevel.end(), directReports.begin(), directReports.end());
+        }
+        levelOffsets.push_back((int)ids.size());
+        level.swap(nextLevel);
+        nextLevel.clear();
+    }
+
+    // Fill the level table once the headcount is known, so it never has to grow
+    levels.reserve(ids.size());
+    for (int depth = 0; depth < getNumLevels(); depth++) {
+        for (int i = levelOffsets[depth]; i < levelOffsets[depth + 1]; i++) {
+            levels.put(ids[i], depth);
+        }
+    }
+}
+
+int OrgLevelIndex::size() const {
+    return (int)ids.size();
+}
+
+int OrgLevelIndex::getNumLevels() const {
+    return (int)levelOffsets.size() - 1;
+}
+
+int OrgLevelIndex::getLevelSize(int level) const {
+    if (level < 0 || level >= getNumLevels()) {
+        return 0;
+    }
+    return levelOffsets[level + 1] - levelOffsets[level];
+}
+
+const int* OrgLevelIndex::levelIDsBegin(int level) const {
+    return ids.data() + levelOffsets[level];
+}
+
+const int* OrgLevelIndex::levelIDsEnd(int level) const {
+    return ids.data() + levelOffsets[level + 1];
+}
+
+vector<int> OrgLevelIndex::findLevelHeadcounts() const {
+    vector<int> headcounts(getNumLevels());
+    for (int level = 0; level < getNumLevels(); level++) {
+        headcounts[level] = levelOffsets[level + 1] - levelOffsets[level];
+    }
+    return headcounts;
+}
+
+int OrgLevelIndex::findEmployeeLevel(int e_id, int headLevel) const {
+    const int* level = levels.find(e_id);
+    return (level == nullptr) ? Employee::NOT_FOUND : headLevel + *level;
+}
+
+/**
+ * Count the employees at every level of a chart in one breadth-first walk.
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ * @return      the headcount of every level, the head's level first, empty for an empty chart
+ */
+vector<int> OrgLevelIndex::countEmployeesPerLevel(Employee* head) {
+    vector<int> headcounts;
+    vector<Employee*> level;
+    vector<Employee*> nextLevel;
+    if (head != nullptr) {
+        level.push_back(head);
+    }
+
+    while (!level.empty()) {
+        headcounts.push_back((int)level.size());
+        for (size_t i = 0; i < level.size(); i++) {
+            const vector<Employee*> &directReports = level[i]->getDirectReports();
+            nextLevel.insert(nextLevel.end(), directReports.begin(), directReports.end());
+        }
+        level.swap(nextLevel);
+        nextLevel.clear();
+    }
+    return headcounts;
+}
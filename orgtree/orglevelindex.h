@@ -0,0 +1,77 @@
+#ifndef ORGLEVELINDEX_H
+#define ORGLEVELINDEX_H
+
+#include <vector>
+
+#include "orgtree.h"
+#include "idhashmap.h"
+
+using namespace std;
+
+// A preprocessed index of the levels of an organization chart.
+//
+// Building the index walks the chart once in breadth-first order, level by level, so the
+// employee IDs of every level end up next to each other: level k is ids[levelOffsets[k]] ..
+// ids[levelOffsets[k + 1] - 1], in the order of the chart. The level of every employee is kept
+// in a hash table, so findEmployeeLevel is O(1) instead of a walk of the chart.
+//
+// The index is a snapshot of the chart: it has to be rebuilt after the chart changes.
+class OrgLevelIndex {
+
+private:
+    vector<int> ids;            // employee IDs in breadth-first order
+    vector<int> levelOffsets;   // index in ids of the first employee of each level, then ids.size()
+    IdHashMap<int> levels;      // employee ID to level, the head has a level of 0
+
+public:
+    /**
+     * Preprocess the organization chart under head.
+     * The Employee tree is only read, and it can be deleted once the index is built.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit OrgLevelIndex(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    // Number of levels in the chart, 0 for an empty chart
+    int getNumLevels() const;
+
+    // Number of employees at level, 0 if the chart has no such level
+    int getLevelSize(int level) const;
+
+    // Employee IDs at level, 0 <= level < getNumLevels(), in the order of the chart
+    const int* levelIDsBegin(int level) const;
+    const int* levelIDsEnd(int level) const;
+
+    /**
+     * Number of employees at every level, the head's level first.
+     *
+     * @return   the headcount of levels 0 .. getNumLevels() - 1
+     */
+    vector<int> findLevelHeadcounts() const;
+
+    /**
+     * Find the level of employee e_id in the organization chart. O(1)
+     * Same result as Orgtree::findEmployeeLevel on the preprocessed chart.
+     *
+     * @param  e_id      the employee id being searched
+     * @param  headLevel the level of the head employee of the organization
+     * @return    the level of the employee in the org chart
+     *            returns Employee::NOT_FOUND if e_id is not present
+     */
+    int findEmployeeLevel(int e_id, int headLevel) const;
+
+    /**
+     * Count the employees at every level of a chart in one breadth-first walk, without
+     * building an index. Only two levels are held in memory at a time.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     * @return      the headcount of every level, the head's level first, empty for an empty chart
+     */
+    static vector<int> countEmployeesPerLevel(Employee* head);
+
+};
+
+#endif
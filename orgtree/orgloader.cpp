@@ -0,0 +1,396 @@
+#include "orgloader.h"
+#include "idhashmap.h"
+#include "orgtraversal.h"
+#include "orgwriter.h"
+
+#include <fcntl.h>      // open
+#include <string.h>     // memcpy
+#include <sys/mman.h>   // mmap, madvise, munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close
+#include <thread>
+
+// Number of parsing threads, 0 meaning one per core, and never more than the number of bytes to parse
+static int parsingThreads(int numThreads, size_t length) {
+    if (numThreads <= 0) {
+        numThreads = (int)thread::hardware_concurrency();
+    }
+    if (numThreads <= 0) {
+        numThreads = 1;
+    }
+    if ((size_t)numThreads > length) {
+        numThreads = (length > 0) ? (int)length : 1;
+    }
+    return numThreads;
+}
+
+// Parse an optionally negative decimal integer at p, moving p past it
+static bool parseInt(const char* &p, const char* end, int &value) {
+    bool negative = (p < end && *p == '-');
+    if (negative) {
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+
+    long long magnitude = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        magnitude = magnitude * 10 + (*p - '0');
+        if (magnitude > 2147483648LL) {
+            return false;
+        }
+        p++;
+    }
+    if (!negative && magnitude > 2147483647LL) {
+        return false;
+    }
+    value = (int)(negative ? -magnitude : magnitude);
+    return true;
+}
+
+static void skipBlanks(const char* &p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+}
+
+/**
+ * Parse the CSV rows in begin .. end, which starts at the beginning of a line.
+ *
+ * @return  false if a row is malformed
+ */
+bool OrgLoader::parseCsvChunk(const char* begin, const char* end, vector<pair<int, int> > &edges) {
+    const char* p = begin;
+
+    while (p < end) {
+        skipBlanks(p, end);
+
+        // Empty lines are skipped
+        if (p < end && (*p == '\n' || *p == '\r')) {
+            p++;
+            continue;
+        }
+        if (p == end) {
+            break;
+        }
+
+        int e_id;
+        int m_id = Employee::EMPTY_EMPLOYEEID;
+        if (!parseInt(p, end, e_id)) {
+            return false;
+        }
+        skipBlanks(p, end);
+        if (p == end || *p != ',') {
+            return false;
+        }
+        p++;
+        skipBlanks(p, end);
+
+        // An empty manager field marks the head
+        if (p < end && *p != '\n' && *p != '\r') {
+            if (!parseInt(p, end, m_id)) {
+                return false;
+            }
+            skipBlanks(p, end);
+        }
+        if (p < end && *p == '\r') {
+            p++;
+        }
+        if (p < end) {
+            if (*p != '\n') {
+                return false;
+            }
+            p++;
+        }
+
+        edges.push_back(make_pair(e_id, m_id));
+    }
+    return true;
+}
+
+/**
+ * Parse a whole CSV file, split into chunks that start right after a line break.
+ *
+ * @return  false if a row is malformed
+ */
+bool OrgLoader::parseCsv(const char* data, size_t length, int numThreads, vector<pair<int, int> > &edges) {
+    const char* end = data + length;
+
+    // Skip a header line
+    const char* first = data;
+    while (first < end && (*first == ' ' || *first == '\t')) {
+        first++;
+    }
+    if (first < end && *first != '-' && (*first < '0' || *first > '9')) {
+        while (first < end && *first != '\n') {
+            first++;
+        }
+        if (first < end) {
+            first++;
+        }
+    }
+    length = end - first;
+
+    // Move every chunk boundary forward to the start of the next line
+    numThreads = parsingThreads(numThreads, length);
+    vector<const char*> bounds(numThreads + 1, end);
+    bounds[0] = first;
+    for (int t = 1; t < numThreads; t++) {
+        const char* bound = first + (length / numThreads) * t;
+        if (bound < bounds[t - 1]) {
+            bound = bounds[t - 1];
+        }
+        while (bound < end && bound[-1] != '\n') {
+            bound++;
+        }
+        bounds[t] = bound;
+    }
+
+    vector<vector<pair<int, int> > > chunkEdges(numThreads);
+    vector<char> chunkParsed(numThreads, 0);
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) {
+        workers.push_back(thread([&, t]() {
+            chunkParsed[t] = parseCsvChunk(bounds[t], bounds[t + 1], chunkEdges[t]);
+        }));
+    }
+    chunkParsed[0] = parseCsvChunk(bounds[0], bounds[1], chunkEdges[0]);
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+
+    // Concatenate the chunks in file order
+    size_t numEdges = 0;
+    for (int t = 0; t < numThreads; t++) {
+        if (!chunkParsed[t]) {
+            return false;
+        }
+        numEdges += chunkEdges[t].size();
+    }
+    edges.reserve(numEdges);
+    for (int t = 0; t < numThreads; t++) {
+        edges.insert(edges.end(), chunkEdges[t].begin(), chunkEdges[t].end());
+    }
+    return true;
+}
+
+/**
+ * Copy the binary rows into edges, every thread copying its own range of rows.
+ *
+ * @return  false if the file does not hold a whole number of rows
+ */
+bool OrgLoader::parseBinary(const char* data, size_t length, int numThreads, vector<pair<int, int> > &edges) {
+    const size_t ROW_SIZE = 2 * sizeof(int32_t);
+    if (length % ROW_SIZE != 0) {
+        return false;
+    }
+
+    size_t numRows = length / ROW_SIZE;
+    edges.resize(numRows);
+    numThreads = parsingThreads(numThreads, numRows);
+
+    // Rows are copied field by field, since the mapping gives no alignment guarantee for them
+    auto copyRows = [&](int t) {
+        size_t lastRow = numRows * (t + 1) / numThreads;
+        for (size_t row = numRows * t / numThreads; row < lastRow; row++) {
+            int32_t fields[2];
+            memcpy(fields, data + row * ROW_SIZE, ROW_SIZE);
+            edges[row] = make_pair((int)fields[0], (int)fields[1]);
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) {
+        workers.push_back(thread(copyRows, t));
+    }
+    copyRows(0);
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    return true;
+}
+
+/**
+ * Memory-map a file, parse it, and build the chart from its edges.
+ */
+Employee* OrgLoader::loadFile(const string &path, bool binary, int numThreads) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    size_t length = (size_t)info.st_size;
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+    madvise(mapped, length, MADV_SEQUENTIAL);
+
+    vector<pair<int, int> > edges;
+    const char* data = (const char*)mapped;
+    bool parsed = binary ? parseBinary(data, length, numThreads, edges)
+                         : parseCsv(data, length, numThreads, edges);
+    munmap(mapped, length);
+
+    return parsed ? buildFromEdges(edges) : nullptr;
+}
+
+Employee* OrgLoader::loadCsv(const string &path, int numThreads) {
+    return loadFile(path, false, numThreads);
+}
+
+Employee* OrgLoader::loadBinary(const string &path, int numThreads) {
+    return loadFile(path, true, numThreads);
+}
+
+/**
+ * Build an organization chart from (employee, manager) edges.
+ *
+ * <p>
+ * Pass 1 numbers the employees densely in row order, pass 2 resolves every manager to its
+ * number, pass 3 groups the direct reports per manager with a counting sort that keeps the
+ * row order, and pass 4 creates the Employee nodes top-down from the head. Employees that
+ * cannot be reached from the head, because of a management cycle, fail the build.
+ *
+ * @param  edges (employee id, manager id) pairs, Employee::EMPTY_EMPLOYEEID as the manager of the head
+ * @return   the head of the new organization chart, nullptr if the edges do not describe one tree
+ */
+Employee* OrgLoader::buildFromEdges(const vector<pair<int, int> > &edges) {
+    int n = (int)edges.size();
+    if (n == 0) {
+        return nullptr;
+    }
+
+    // Pass 1: dense numbers, in row order
+    IdHashMap<int> denseByID;
+    denseByID.reserve(n);
+    for (int i = 0; i < n; i++) {
+        if (denseByID.contains(edges[i].first)) {
+            return nullptr;
+        }
+        denseByID.put(edges[i].first, i);
+    }
+
+    // Pass 2: resolve the managers and find the one head
+    vector<int> managers(n);
+    int head = -1;
+    for (int i = 0; i < n; i++) {
+        if (edges[i].second == Employee::EMPTY_EMPLOYEEID) {
+            if (head != -1) {
+                return nullptr;
+            }
+            head = i;
+            managers[i] = -1;
+            continue;
+        }
+        const int* manager = denseByID.find(edges[i].second);
+        if (manager == nullptr) {
+            return nullptr;
+        }
+        managers[i] = *manager;
+    }
+    if (head == -1) {
+        return nullptr;
+    }
+
+    // Pass 3: direct reports of employee i are reports[reportOffsets[i] .. reportOffsets[i + 1] - 1]
+    vector<int> reportOffsets(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        if (managers[i] != -1) {
+            reportOffsets[managers[i] + 1]++;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        reportOffsets[i + 1] += reportOffsets[i];
+    }
+    vector<int> reports(reportOffsets[n]);
+    vector<int> nextReport(reportOffsets.begin(), reportOffsets.end() - 1);
+    for (int i = 0; i < n; i++) {
+        if (managers[i] != -1) {
+            reports[nextReport[managers[i]]++] = i;
+        }
+    }
+
+    // Pass 4: create the Employee nodes top-down
+    Employee* headEmployee = new Employee(edges[head].first);
+    vector<pair<Employee*, int> > toCreate(1, make_pair(headEmployee, head));
+    int numCreated = 1;
+    vector<int> reportIDs;
+
+    while (!toCreate.empty()) {
+        Employee* employee = toCreate.back().first;
+        int i = toCreate.back().second;
+        toCreate.pop_back();
+
+        reportIDs.clear();
+        for (int r = reportOffsets[i]; r < reportOffsets[i + 1]; r++) {
+            reportIDs.push_back(edges[reports[r]].first);
+        }
+        if (reportIDs.empty()) {
+            continue;
+        }
+        employee->addDirectReports(reportIDs);
+        numCreated += (int)reportIDs.size();
+
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (size_t r = 0; r < directReports.size(); r++) {
+            toCreate.push_back(make_pair(directReports[r], reports[reportOffsets[i] + r]));
+        }
+    }
+
+    // Employees in a management cycle are never reached from the head
+    if (numCreated != n) {
+        vector<Employee*> toDelete(1, headEmployee);
+        while (!toDelete.empty()) {
+            Employee* employee = toDelete.back();
+            toDelete.pop_back();
+            const vector<Employee*> &directReports = employee->getDirectReports();
+            toDelete.insert(toDelete.end(), directReports.begin(), directReports.end());
+            delete employee;
+        }
+        return nullptr;
+    }
+    return headEmployee;
+}
+
+/**
+ * Write the edges of an organization chart in pre-order, buffering the output in blocks.
+ *
+ * @return  true if the file was written
+ */
+bool OrgLoader::writeEdges(Employee* head, const string &path, bool binary) {
+    const size_t BLOCK_SIZE = 1 << 20;
+
+    FileSink sink(path);
+    if (!sink.isGood()) {
+        return false;
+    }
+    OrgWriter writer(sink, BLOCK_SIZE);
+
+    // Stop early once a write fails
+    OrgTraversal::preOrder(head, [&writer, binary](Employee* employee, int level) {
+        int m_id = (level == 0) ? Employee::EMPTY_EMPLOYEEID : employee->getManager()->getEmployeeID();
+        if (binary) {
+            int32_t fields[2] = { employee->getEmployeeID(), m_id };
+            writer.write((const char*)fields, sizeof(fields));
+        }
+        else {
+            writer.writeInt(employee->getEmployeeID());
+            writer.writeChar(',');
+            writer.writeInt(m_id);
+            writer.writeChar('\n');
+        }
+        return writer.isGood() ? CONTINUE : STOP;
+    });
+
+    writer.flush();
+    return writer.isGood();
+}
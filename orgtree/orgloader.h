@@ -0,0 +1,78 @@
+#ifndef ORGLOADER_H
+#define ORGLOADER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "orgtree.h"
+
+using namespace std;
+
+// Bulk loading of an organization chart from an (employee, manager) edge file.
+//
+// The file is memory-mapped and split into one chunk per thread, and every thread parses
+// its own chunk. The edges are then turned into a tree in a few linear passes: every employee
+// ID gets a dense number, every manager ID is resolved to its dense number, the direct reports
+// are grouped per manager with a counting sort, and the Employee nodes are created top-down.
+// Direct reports keep the order of their rows in the file.
+//
+// Two formats are supported:
+// - CSV: one "employee,manager" row per line, with an empty manager or -1 for the head.
+//   An optional header line, anything not starting with a digit or '-', is skipped.
+// - binary: consecutive pairs of 32-bit integers in native byte order, employee then manager,
+//   with -1 as the manager of the head.
+//
+// Every row must name a different employee, exactly one row must be the head, and every
+// manager must be one of the employees; otherwise nothing is built and nullptr is returned.
+class OrgLoader {
+
+private:
+    static bool parseCsvChunk(const char* begin, const char* end, vector<pair<int, int> > &edges);
+    static bool parseCsv(const char* data, size_t length, int numThreads, vector<pair<int, int> > &edges);
+    static bool parseBinary(const char* data, size_t length, int numThreads, vector<pair<int, int> > &edges);
+    static Employee* loadFile(const string &path, bool binary, int numThreads);
+
+public:
+    /**
+     * Load an organization chart from a CSV edge file.
+     *
+     * @param  path       path of the CSV file
+     * @param  numThreads number of threads parsing the file, 0 to use one per core
+     * @return   the head of the new organization chart, delete it with Orgtree::deleteOrgtree
+     *           nullptr if the file cannot be read, is malformed, or does not describe one tree
+     */
+    static Employee* loadCsv(const string &path, int numThreads);
+
+    /**
+     * Load an organization chart from a binary edge file.
+     *
+     * @param  path       path of the binary file
+     * @param  numThreads number of threads parsing the file, 0 to use one per core
+     * @return   the head of the new organization chart, delete it with Orgtree::deleteOrgtree
+     *           nullptr if the file cannot be read, is malformed, or does not describe one tree
+     */
+    static Employee* loadBinary(const string &path, int numThreads);
+
+    /**
+     * Build an organization chart from (employee, manager) edges, in the order of the edges.
+     *
+     * @param  edges (employee id, manager id) pairs, Employee::EMPTY_EMPLOYEEID as the manager of the head
+     * @return   the head of the new organization chart, delete it with Orgtree::deleteOrgtree
+     *           nullptr if the edges are empty or do not describe one tree
+     */
+    static Employee* buildFromEdges(const vector<pair<int, int> > &edges);
+
+    /**
+     * Write the edges of an organization chart, in pre-order, as a CSV or binary edge file.
+     *
+     * @param  head   the head / root Employee of the organization chart
+     * @param  path   path of the file to write
+     * @param  binary true for the binary format, false for CSV
+     * @return   true if the file was written
+     */
+    static bool writeEdges(Employee* head, const string &path, bool binary);
+
+};
+
+#endif
@@ -0,0 +1,233 @@
+#include "orgmerkletree.h"
+
+#include <algorithm>    // sort
+
+const int OrgMerkleTree::NO_INDEX;
+
+// The splitmix64 finalizer: every input bit changes about half of the output bits
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Order changes by the pre-order index they were found at
+static bool byIndex(const pair<int, OrgMerkleTree::Change> &a, const pair<int, OrgMerkleTree::Change> &b) {
+    return a.first < b.first;
+}
+
+static void sortByIndex(vector<pair<int, OrgMerkleTree::Change> > &found, vector<OrgMerkleTree::Change> &changes) {
+    sort(found.begin(), found.end(), byIndex);
+    for (size_t i = 0; i < found.size(); i++) {
+        changes.push_back(found[i].second);
+    }
+}
+
+/**
+ * Number the chart in pre-order, walking it with an explicit stack, then hash the subtrees
+ * from the last employee back to the head.
+ */
+OrgMerkleTree::OrgMerkleTree(Employee* head) {
+    if (head == nullptr) {
+        return;
+    }
+
+    // Each stack entry is an employee still to be numbered, together with its manager's index
+    vector<pair<Employee*, int> > toVisit;
+    toVisit.push_back(make_pair(head, NO_INDEX));
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back().first;
+        int parent = toVisit.back().second;
+        toVisit.pop_back();
+
+        int index = (int)ids.size();
+        ids.push_back(employee->getEmployeeID());
+        parents.push_back(parent);
+
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (int i = (int)directReports.size() - 1; i >= 0; i--) {
+            toVisit.push_back(make_pair(directReports[i], index));
+        }
+    }
+
+    indexByID.reserve(ids.size());
+    for (int i = 0; i < (int)ids.size(); i++) {
+        indexByID.put(ids[i], i);
+    }
+
+    // Every employee comes after its manager, so a backward pass finishes each subtree
+    // before adding it to the manager's
+    vector<int> subtreeSizes(ids.size(), 1);
+    vector<uint64_t> reportSums(ids.size(), 0);
+    hashes.resize(ids.size());
+    for (int i = (int)ids.size() - 1; i >= 0; i--) {
+        hashes[i] = mix(mix((uint64_t)(uint32_t)ids[i]) + reportSums[i]);
+        if (parents[i] != NO_INDEX) {
+            subtreeSizes[parents[i]] += subtreeSizes[i];
+            reportSums[parents[i]] += mix(hashes[i] ^ 0x9e3779b97f4a7c15ULL);
+        }
+    }
+    subtreeEnds.resize(ids.size());
+    for (int i = 0; i < (int)ids.size(); i++) {
+        subtreeEnds[i] = i + subtreeSizes[i];
+    }
+}
+
+int OrgMerkleTree::indexOf(int e_id) const {
+    const int* index = indexByID.find(e_id);
+    return (index == nullptr) ? NO_INDEX : *index;
+}
+
+int OrgMerkleTree::managerIDAt(int index) const {
+    return (parents[index] == NO_INDEX) ? Employee::NOT_FOUND : ids[parents[index]];
+}
+
+int OrgMerkleTree::size() const {
+    return (int)ids.size();
+}
+
+uint64_t OrgMerkleTree::getRootHash() const {
+    return ids.empty() ? 0 : hashes[0];
+}
+
+bool OrgMerkleTree::getSubtreeHash(int e_id, uint64_t &hash) const {
+    int index = indexOf(e_id);
+    if (index == NO_INDEX) {
+        return false;
+    }
+    hash = hashes[index];
+    return true;
+}
+
+/**
+ * Classify employee a of the new chart: inserted if it is not in the old chart, moved if its
+ * manager changed. Its subtree is queued for comparison if it is new or its hash changed.
+ */
+void OrgMerkleTree::matchNewEmployee(const OrgMerkleTree &before, const OrgMerkleTree &after, int a,
+                                     vector<pair<int, Change> > &inserts, vector<pair<int, Change> > &moves,
+                                     vector<pair<int, int> > &toCompare, vector<int> &inserted) {
+    int b = before.indexOf(after.ids[a]);
+    Change change = { after.ids[a], Employee::NOT_FOUND, after.managerIDAt(a) };
+    if (b == NO_INDEX) {
+        inserts.push_back(make_pair(a, change));
+        inserted.push_back(a);
+        return;
+    }
+
+    change.oldManagerID = before.managerIDAt(b);
+    if (change.oldManagerID != change.newManagerID) {
+        moves.push_back(make_pair(a, change));
+    }
+    if (before.hashes[b] != after.hashes[a]) {
+        toCompare.push_back(make_pair(b, a));
+    }
+}
+
+/**
+ * Classify employee b of the old chart: deleted if it is not in the new chart.
+ * Employees that are still there are moves or unchanged, which the new chart's side reports.
+ */
+void OrgMerkleTree::matchOldEmployee(const OrgMerkleTree &before, const OrgMerkleTree &after, int b,
+                                     vector<pair<int, Change> > &deletes, vector<int> &deleted) {
+    if (after.indexOf(before.ids[b]) == NO_INDEX) {
+        Change change = { before.ids[b], before.managerIDAt(b), Employee::NOT_FOUND };
+        deletes.push_back(make_pair(b, change));
+        deleted.push_back(b);
+    }
+}
+
+/**
+ * Find the changes from one chart to the next.
+ *
+ * <p>
+ * The heads are matched as if both charts hung under one shared manager. Then three kinds of
+ * subtrees are expanded, each by matching the direct reports of its head:
+ *   - an employee in both charts whose subtree hash differs: the reports on both sides
+ *   - an inserted employee: its reports in the new chart, which are inserted or moved in
+ *   - a deleted employee: its reports in the old chart, which are deleted or moved out
+ * Subtrees with equal hashes are identical, and are never entered.
+ */
+void OrgMerkleTree::diff(const OrgMerkleTree &before, const OrgMerkleTree &after, Diff &changes) {
+    changes = Diff();
+
+    // Changes with the pre-order index they were found at, sorted at the end
+    vector<pair<int, Change> > inserts, moves, deletes;
+
+    vector<pair<int, int> > toCompare;  // (old index, new index) of employees whose subtrees differ
+    vector<int> inserted;               // new indices of inserted employees
+    vector<int> deleted;                // old indices of deleted employees
+
+    if (!after.ids.empty()) {
+        matchNewEmployee(before, after, 0, inserts, moves, toCompare, inserted);
+        changes.numVisited++;
+    }
+    if (!before.ids.empty()) {
+        matchOldEmployee(before, after, 0, deletes, deleted);
+        changes.numVisited++;
+    }
+
+    while (!toCompare.empty() || !inserted.empty() || !deleted.empty()) {
+        int a = NO_INDEX;
+        int b = NO_INDEX;
+        if (!toCompare.empty()) {
+            b = toCompare.back().first;
+            a = toCompare.back().second;
+            toCompare.pop_back();
+        }
+        else if (!inserted.empty()) {
+            a = inserted.back();
+            inserted.pop_back();
+        }
+        else {
+            b = deleted.back();
+            deleted.pop_back();
+        }
+
+        // The direct reports of an employee start right after it, each one after the previous one's subtree
+        if (a != NO_INDEX) {
+            for (int r = a + 1; r < after.subtreeEnds[a]; r = after.subtreeEnds[r]) {
+                matchNewEmployee(before, after, r, inserts, moves, toCompare, inserted);
+                changes.numVisited++;
+            }
+        }
+        if (b != NO_INDEX) {
+            for (int r = b + 1; r < before.subtreeEnds[b]; r = before.subtreeEnds[r]) {
+                matchOldEmployee(before, after, r, deletes, deleted);
+                changes.numVisited++;
+            }
+        }
+    }
+
+    sortByIndex(inserts, changes.inserts);
+    sortByIndex(moves, changes.moves);
+    sortByIndex(deletes, changes.deletes);
+}
+
+bool OrgMerkleTree::applyChanges(const Diff &changes, DynamicOrgtree &org) {
+    bool applied = true;
+
+    // A new employee's manager is either in the old chart or inserted before it
+    for (size_t i = 0; i < changes.inserts.size(); i++) {
+        const Change &change = changes.inserts[i];
+        int managerID = (change.newManagerID == Employee::NOT_FOUND) ? Employee::EMPTY_EMPLOYEEID : change.newManagerID;
+        applied = org.addEmployee(change.employeeID, managerID) && applied;
+    }
+
+    // In the order of the new chart, the managers above each new manager are already in their
+    // final places, so the moved employee is never one of them
+    for (size_t i = 0; i < changes.moves.size(); i++) {
+        const Change &change = changes.moves[i];
+        applied = change.newManagerID != Employee::NOT_FOUND &&
+                  org.moveEmployee(change.employeeID, change.newManagerID) && applied;
+    }
+
+    // Everyone still under a deleted employee is deleted too, so deleting from the bottom up
+    // only ever removes employees without direct reports
+    for (size_t i = changes.deletes.size(); i-- > 0; ) {
+        applied = org.removeEmployee(changes.deletes[i].employeeID) && applied;
+    }
+    return applied;
+}
@@ -0,0 +1,119 @@
+#ifndef ORGMERKLETREE_H
+#define ORGMERKLETREE_H
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include "orgtree.h"
+#include "idhashmap.h"
+#include "dynamicorgtree.h"
+
+using namespace std;
+
+// Structural hashes of every subtree of an organization chart, to find what changed between
+// two versions of a chart without comparing them employee by employee.
+//
+// The hash of an employee's subtree mixes the employee ID with the hashes of its direct
+// reports' subtrees, computed bottom-up in one backward pass over the pre-order. The report
+// hashes are mixed and added, so the order of direct reports does not matter: two subtrees
+// have the same hash exactly when they hold the same employees under the same managers
+// (up to 64-bit hash collisions).
+//
+// diff() walks both charts from the head together and only descends into employees whose
+// subtree hashes differ, so its cost grows with the size of the changed regions and the
+// number of direct reports along the way to them, not with the size of the charts.
+class OrgMerkleTree {
+
+public:
+    // Index of a missing employee, and the manager index of the head
+    static const int NO_INDEX = -1;
+
+    // An employee added, moved or removed between two charts.
+    // Manager IDs are Employee::NOT_FOUND where there is no manager: for the head,
+    // before an insert and after a delete.
+    struct Change {
+        int employeeID;
+        int oldManagerID;
+        int newManagerID;
+    };
+
+    // What changed between two charts
+    struct Diff {
+        vector<Change> inserts;     // in the new chart only, managers before their reports
+        vector<Change> moves;       // in both charts under different managers, managers first in the new chart
+        vector<Change> deletes;     // in the old chart only, managers before their reports
+        int numVisited;             // employees looked at to find the changes
+
+        Diff() : numVisited(0) {}
+
+        bool empty() const {
+            return inserts.empty() && moves.empty() && deletes.empty();
+        }
+    };
+
+private:
+    vector<int> ids;            // employee IDs in pre-order
+    vector<int> parents;        // pre-order index of the direct manager, NO_INDEX for the head
+    vector<int> subtreeEnds;    // one past the pre-order index of the last employee under each employee
+    vector<uint64_t> hashes;    // hash of every employee's subtree
+    IdHashMap<int> indexByID;   // employee ID to pre-order index
+
+    int indexOf(int e_id) const;
+    int managerIDAt(int index) const;
+
+    // Steps of diff(): classify one employee, and queue what still has to be looked at
+    static void matchNewEmployee(const OrgMerkleTree &before, const OrgMerkleTree &after, int a,
+                                 vector<pair<int, Change> > &inserts, vector<pair<int, Change> > &moves,
+                                 vector<pair<int, int> > &toCompare, vector<int> &inserted);
+    static void matchOldEmployee(const OrgMerkleTree &before, const OrgMerkleTree &after, int b,
+                                 vector<pair<int, Change> > &deletes, vector<int> &deleted);
+
+public:
+    /**
+     * Hash every subtree of the organization chart under head.
+     * The Employee tree is only read, and it can be deleted once the hashes are built.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit OrgMerkleTree(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    // Hash of the whole chart, 0 for an empty chart
+    uint64_t getRootHash() const;
+
+    /**
+     * Find the hash of the subtree under an employee.
+     *
+     * @param  e_id the employee id being searched
+     * @param  hash hash of the subtree under e, including e
+     * @return      is employee found
+     */
+    bool getSubtreeHash(int e_id, uint64_t &hash) const;
+
+    /**
+     * Find the employees added, moved to a new manager and removed from one chart to the next.
+     * Employees whose manager is unchanged are not reported, even if their subtree changed.
+     *
+     * @param  before the old chart
+     * @param  after  the new chart
+     * @param  changes the changes from before to after
+     */
+    static void diff(const OrgMerkleTree &before, const OrgMerkleTree &after, Diff &changes);
+
+    /**
+     * Update a DynamicOrgtree of the old chart to the new one, touching only the changed employees:
+     * inserts, then moves, then deletes from the bottom up, so every step finds its managers in place.
+     *
+     * @param  changes the changes found by diff()
+     * @param  org     a DynamicOrgtree holding the old chart
+     * @return   true if every change was applied, false if one could not be,
+     *           e.g. a new head when the old head is still in the chart
+     */
+    static bool applyChanges(const Diff &changes, DynamicOrgtree &org);
+
+};
+
+#endif
@@ -0,0 +1,247 @@
+#include "orgpathindex.h"
+
+#include <limits.h>     // LLONG_MIN, LLONG_MAX
+#include <utility>      // std::swap
+
+/**
+ * Preprocess the organization chart under head.
+ *
+ * <p>
+ * A pre-order walk with an explicit stack records every employee's manager and attribute,
+ * and a backward pass adds up the subtree sizes that pick each manager's heavy direct report.
+ * A second walk numbers the employees, visiting the heavy direct report right after its
+ * manager so that every heavy path gets consecutive positions. Finally the segment tree is
+ * filled bottom-up from the leaves.
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ */
+OrgPathIndex::OrgPathIndex(Employee* head) {
+
+    // Walk 1: pre-order index, manager and direct reports of every employee
+    vector<Employee*> employees;
+    vector<int> managers;
+    vector<pair<Employee*, int> > toVisit;
+    if (head != nullptr) {
+        toVisit.push_back(make_pair(head, -1));
+    }
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back().first;
+        int manager = toVisit.back().second;
+        toVisit.pop_back();
+
+        int index = (int)employees.size();
+        employees.push_back(employee);
+        managers.push_back(manager);
+
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (int i = (int)directReports.size() - 1; i >= 0; i--) {
+            toVisit.push_back(make_pair(directReports[i], index));
+        }
+    }
+    int n = (int)employees.size();
+
+    // Every employee comes after its manager, so a backward pass sees each subtree complete.
+    // The heavy direct report is the one with the largest subtree, -1 for employees with no reports
+    vector<int> subtreeSizes(n, 1);
+    vector<int> heavy(n, -1);
+    for (int i = n - 1; i > 0; i--) {
+        subtreeSizes[managers[i]] += subtreeSizes[i];
+    }
+    for (int i = 1; i < n; i++) {
+        int m = managers[i];
+        if (heavy[m] == -1 || subtreeSizes[i] > subtreeSizes[heavy[m]]) {
+            heavy[m] = i;
+        }
+    }
+
+    // Direct reports of every employee in compressed sparse row form
+    vector<int> childOffsets(n + 1, 0);
+    for (int i = 1; i < n; i++) {
+        childOffsets[managers[i] + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+    vector<int> children(n > 0 ? n - 1 : 0);
+    vector<int> nextChild(childOffsets.begin(), childOffsets.end() - 1);
+    for (int i = 1; i < n; i++) {
+        children[nextChild[managers[i]]++] = i;
+    }
+
+    // Walk 2: number the employees, the heavy direct report popped right after its manager
+    ids.resize(n);
+    parents.resize(n);
+    depths.resize(n);
+    pathHeads.resize(n);
+    tree.resize(2 * (size_t)n);
+    positions.reserve(n);
+
+    vector<int> positionByIndex(n);
+    vector<int> toNumber;
+    if (n > 0) {
+        toNumber.push_back(0);
+    }
+    int next = 0;
+    while (!toNumber.empty()) {
+        int i = toNumber.back();
+        toNumber.pop_back();
+
+        int position = next++;
+        positionByIndex[i] = position;
+        ids[position] = employees[i]->getEmployeeID();
+        positions.put(ids[position], position);
+
+        int manager = (managers[i] == -1) ? -1 : positionByIndex[managers[i]];
+        parents[position] = manager;
+        depths[position] = (manager == -1) ? 0 : depths[manager] + 1;
+        bool continuesPath = manager != -1 && heavy[managers[i]] == i;
+        pathHeads[position] = continuesPath ? pathHeads[manager] : position;
+
+        long long value = employees[i]->getAttribute();
+        PathAggregate leaf = { value, value, value, 1 };
+        tree[n + position] = leaf;
+
+        for (int c = childOffsets[i]; c < childOffsets[i + 1]; c++) {
+            if (children[c] != heavy[i]) {
+                toNumber.push_back(children[c]);
+            }
+        }
+        if (heavy[i] != -1) {
+            toNumber.push_back(heavy[i]);
+        }
+    }
+
+    for (int node = n - 1; node > 0; node--) {
+        tree[node] = combine(tree[2 * node], tree[2 * node + 1]);
+    }
+}
+
+int OrgPathIndex::size() const {
+    return (int)ids.size();
+}
+
+int OrgPathIndex::positionOf(int e_id) const {
+    const int* position = positions.find(e_id);
+    return (position == nullptr) ? -1 : *position;
+}
+
+OrgPathIndex::PathAggregate OrgPathIndex::combine(const PathAggregate &a, const PathAggregate &b) {
+    PathAggregate result;
+    result.sum = a.sum + b.sum;
+    result.min = (b.min < a.min) ? b.min : a.min;
+    result.max = (b.max > a.max) ? b.max : a.max;
+    result.count = a.count + b.count;
+    return result;
+}
+
+/**
+ * Aggregate of positions first .. last, climbing the segment tree from both ends.
+ */
+OrgPathIndex::PathAggregate OrgPathIndex::rangeAggregate(int first, int last) const {
+    PathAggregate result = { 0, LLONG_MAX, LLONG_MIN, 0 };
+    int n = size();
+    for (int lo = first + n, hi = last + n + 1; lo < hi; lo /= 2, hi /= 2) {
+        if (lo & 1) {
+            result = combine(result, tree[lo++]);
+        }
+        if (hi & 1) {
+            result = combine(result, tree[--hi]);
+        }
+    }
+    return result;
+}
+
+/**
+ * Climb heavy paths from the employee whose path starts lower, until both are on the same
+ * path: the higher-ranking of the two is then the closest shared manager.
+ */
+int OrgPathIndex::closestSharedManagerPosition(int e1_pos, int e2_pos) const {
+    while (pathHeads[e1_pos] != pathHeads[e2_pos]) {
+        if (depths[pathHeads[e1_pos]] < depths[pathHeads[e2_pos]]) {
+            e2_pos = parents[pathHeads[e2_pos]];
+        } else {
+            e1_pos = parents[pathHeads[e1_pos]];
+        }
+    }
+    return (e1_pos < e2_pos) ? e1_pos : e2_pos;
+}
+
+/**
+ * Aggregate the attributes of the employees on the chain between two employees.
+ *
+ * <p>
+ * The same climb as closestSharedManagerPosition, adding up every stretch of heavy path
+ * it leaves, then the stretch of the last path between the two employees.
+ *
+ * @param  e1_id     id of employee 1
+ * @param  e2_id     id of employee 2, the same as e1_id for a single employee
+ * @param  aggregate the sum, minimum, maximum and number of employees on the path
+ * @return           true if both employees are present, false otherwise and aggregate is unchanged
+ */
+bool OrgPathIndex::findPathAggregate(int e1_id, int e2_id, PathAggregate &aggregate) const {
+    int e1_pos = positionOf(e1_id);
+    int e2_pos = positionOf(e2_id);
+    if (e1_pos == -1 || e2_pos == -1) {
+        return false;
+    }
+
+    PathAggregate result = { 0, LLONG_MAX, LLONG_MIN, 0 };
+    while (pathHeads[e1_pos] != pathHeads[e2_pos]) {
+        if (depths[pathHeads[e1_pos]] < depths[pathHeads[e2_pos]]) {
+            swap(e1_pos, e2_pos);
+        }
+        result = combine(result, rangeAggregate(pathHeads[e1_pos], e1_pos));
+        e1_pos = parents[pathHeads[e1_pos]];
+    }
+    if (e1_pos > e2_pos) {
+        swap(e1_pos, e2_pos);
+    }
+    aggregate = combine(result, rangeAggregate(e1_pos, e2_pos));
+    return true;
+}
+
+int OrgPathIndex::findClosestSharedManager(int e1_id, int e2_id) const {
+    int e1_pos = positionOf(e1_id);
+    int e2_pos = positionOf(e2_id);
+
+    if (e1_pos == -1 && e2_pos == -1) {
+        return Employee::NOT_FOUND;
+    }
+    if (e2_pos == -1) {
+        return e1_id;
+    }
+    if (e1_pos == -1) {
+        return e2_id;
+    }
+    return ids[closestSharedManagerPosition(e1_pos, e2_pos)];
+}
+
+bool OrgPathIndex::getAttribute(int e_id, long long &value) const {
+    int position = positionOf(e_id);
+    if (position == -1) {
+        return false;
+    }
+    value = tree[size() + position].sum;
+    return true;
+}
+
+/**
+ * Change the attribute of an employee, then recombine the segment tree nodes above its leaf.
+ *
+ * @param  e_id  id of the employee
+ * @param  value the new attribute of e
+ * @return       is employee found
+ */
+bool OrgPathIndex::setAttribute(int e_id, long long value) {
+    int position = positionOf(e_id);
+    if (position == -1) {
+        return false;
+    }
+    int node = size() + position;
+    PathAggregate leaf = { value, value, value, 1 };
+    tree[node] = leaf;
+    for (node /= 2; node > 0; node /= 2) {
+        tree[node] = combine(tree[2 * node], tree[2 * node + 1]);
+    }
+    return true;
+}
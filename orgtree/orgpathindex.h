@@ -0,0 +1,105 @@
+#ifndef ORGPATHINDEX_H
+#define ORGPATHINDEX_H
+
+#include <vector>
+
+#include "orgtree.h"
+#include "idhashmap.h"
+
+using namespace std;
+
+// A preprocessed index of employee attributes answering aggregates along the chain of
+// managers between two employees, with point updates.
+//
+// Building the index splits the chart into heavy paths (heavy-light decomposition): every
+// manager continues the path of its direct report with the largest subtree, and the others
+// start paths of their own. Employees are numbered so that every heavy path is a contiguous
+// range, and a segment tree over that numbering keeps the sum, minimum and maximum of every
+// range. Any chain between two employees crosses O(log N) heavy paths, so a path query or a
+// closest shared manager query is O(log^2 N), and an update is O(log N).
+//
+// The index copies the attributes: setAttribute updates the index, not the Employee tree.
+// It is a snapshot of the chart's structure and has to be rebuilt after the chart changes.
+class OrgPathIndex {
+
+public:
+    // Aggregate of the attributes of the employees on a path
+    struct PathAggregate {
+        long long sum;
+        long long min;
+        long long max;
+        int count;          // number of employees on the path, both ends included
+    };
+
+private:
+    // Employees are stored by position: heavy paths are contiguous, a manager comes before its reports
+    vector<int> ids;
+    vector<int> parents;        // position of each employee's manager, -1 for the head
+    vector<int> depths;         // level of each employee, the head has a level of 0
+    vector<int> pathHeads;      // position of the first (highest-ranking) employee of each heavy path
+    IdHashMap<int> positions;   // employee ID to position
+
+    // Segment tree: leaves at size() .. 2 * size() - 1, node i combines nodes 2i and 2i + 1
+    vector<PathAggregate> tree;
+
+    int positionOf(int e_id) const;
+    static PathAggregate combine(const PathAggregate &a, const PathAggregate &b);
+    PathAggregate rangeAggregate(int first, int last) const;
+    int closestSharedManagerPosition(int e1_pos, int e2_pos) const;
+
+public:
+    /**
+     * Preprocess the organization chart under head and the attributes of its employees.
+     * The Employee tree is only read, and it can be deleted once the index is built.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit OrgPathIndex(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    /**
+     * Aggregate the attributes of the employees on the chain from e1 up to their closest
+     * shared manager and down to e2, both ends and the shared manager included. O(log^2 N)
+     *
+     * @param  e1_id     id of employee 1
+     * @param  e2_id     id of employee 2, the same as e1_id for a single employee
+     * @param  aggregate the sum, minimum, maximum and number of employees on the path
+     * @return           true if both employees are present, false otherwise and aggregate is unchanged
+     */
+    bool findPathAggregate(int e1_id, int e2_id, PathAggregate &aggregate) const;
+
+    /**
+     * Find the closest shared manager of two employees e1 and e2. O(log N)
+     * Same result as Orgtree::findClosestSharedManager on the preprocessed chart.
+     *
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   employee ID of the closest shared manager of e1 and e2
+     *           if neither e1 or e2 is present, returns Employee::NOT_FOUND
+     *           if only one of e1 and e2 is present, returns the one that is present
+     */
+    int findClosestSharedManager(int e1_id, int e2_id) const;
+
+    /**
+     * Read the attribute of an employee as stored in the index. O(1)
+     *
+     * @param  e_id  id of the employee
+     * @param  value the attribute of e
+     * @return       is employee found
+     */
+    bool getAttribute(int e_id, long long &value) const;
+
+    /**
+     * Change the attribute of an employee in the index. O(log N)
+     *
+     * @param  e_id  id of the employee
+     * @param  value the new attribute of e
+     * @return       is employee found
+     */
+    bool setAttribute(int e_id, long long value);
+
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "orgquerycache.h"
+
+#include <utility>  // swap
+
+const size_t OrgQueryCache::DEFAULT_CAPACITY;
+
+OrgQueryCache::OrgQueryCache(Employee* head, size_t capacity)
+    : index(EmployeeIndex::acquire(head)), acquired(true), tracked(index->isAttached()), head(head),
+      capacity(capacity > 0 ? capacity : 1), hand(0), generation(index->getGeneration()),
+      numHits(0), numMisses(0), numEvictions(0), numInvalidations(0) {
+    entries.reserve(this->capacity);
+    slots.reserve(this->capacity);
+}
+
+OrgQueryCache::OrgQueryCache(EmployeeIndex &index, size_t capacity)
+    : index(&index), acquired(false), tracked(index.isAttached()), head(index.getHead()),
+      capacity(capacity > 0 ? capacity : 1), hand(0), generation(index.getGeneration()),
+      numHits(0), numMisses(0), numEvictions(0), numInvalidations(0) {
+    entries.reserve(this->capacity);
+    slots.reserve(this->capacity);
+}
+
+OrgQueryCache::~OrgQueryCache() {
+    if (acquired) {
+        EmployeeIndex::release(index);
+    }
+}
+
+/**
+ * Look up a cached result, emptying the cache first if the chart changed since it was filled,
+ * or on every query if its changes are not tracked.
+ *
+ * @return the entry of the query, nullptr if it is not cached
+ */
+OrgQueryCache::Entry* OrgQueryCache::find(int query, int e1_id, int e2_id) {
+    unsigned long long now = index->getGeneration();
+    if (!tracked) {
+        clear();
+    }
+    else if (now != generation) {
+        if (!entries.empty()) {
+            numInvalidations++;
+        }
+        clear();
+        generation = now;
+    }
+
+    Key key = { query, e1_id, e2_id };
+    unordered_map<Key, size_t, KeyHash>::iterator slot = slots.find(key);
+    if (slot == slots.end()) {
+        numMisses++;
+        return nullptr;
+    }
+    numHits++;
+    Entry &entry = entries[slot->second];
+    entry.referenced = true;
+    return &entry;
+}
+
+/**
+ * Make room for a new result with the CLOCK algorithm, and register it under its key.
+ * The caller fills in the result.
+ *
+ * @return the entry of the query
+ */
+OrgQueryCache::Entry& OrgQueryCache::insert(int query, int e1_id, int e2_id) {
+    size_t i;
+    if (entries.size() < capacity) {
+        i = entries.size();
+        entries.push_back(Entry());
+    }
+    else {
+        // Give every referenced entry a second chance, evict the first one that is not
+        while (entries[hand].referenced) {
+            entries[hand].referenced = false;
+            hand = (hand + 1) % capacity;
+        }
+        i = hand;
+        hand = (hand + 1) % capacity;
+        slots.erase(entries[i].key);
+        numEvictions++;
+    }
+
+    Entry &entry = entries[i];
+    Key key = { query, e1_id, e2_id };
+    entry.key = key;
+    entry.referenced = false;
+    slots[key] = i;
+    return entry;
+}
+
+bool OrgQueryCache::findManagersOfEmployee(int e_id, vector<int> &managers) {
+    Entry* cached = find(MANAGERS_OF_EMPLOYEE, e_id, 0);
+    if (cached == nullptr) {
+        cached = &insert(MANAGERS_OF_EMPLOYEE, e_id, 0);
+        cached->managers.clear();
+        cached->found = Orgtree::findManagersOfEmployee(head, e_id, cached->managers);
+    }
+    managers.insert(managers.end(), cached->managers.begin(), cached->managers.end());
+    return cached->found;
+}
+
+// Both pair queries give the same result for (e1, e2) and (e2, e1), so they share one entry
+Employee* OrgQueryCache::findClosestSharedManager(int e1_id, int e2_id) {
+    if (e2_id < e1_id) {
+        swap(e1_id, e2_id);
+    }
+    Entry* cached = find(CLOSEST_SHARED_MANAGER, e1_id, e2_id);
+    if (cached == nullptr) {
+        cached = &insert(CLOSEST_SHARED_MANAGER, e1_id, e2_id);
+        cached->employee = Orgtree::findClosestSharedManager(head, e1_id, e2_id);
+    }
+    return cached->employee;
+}
+
+int OrgQueryCache::findNumOfManagersBetween(int e1_id, int e2_id) {
+    if (e2_id < e1_id) {
+        swap(e1_id, e2_id);
+    }
+    Entry* cached = find(NUM_OF_MANAGERS_BETWEEN, e1_id, e2_id);
+    if (cached == nullptr) {
+        cached = &insert(NUM_OF_MANAGERS_BETWEEN, e1_id, e2_id);
+        cached->number = Orgtree::findNumOfManagersBetween(head, e1_id, e2_id);
+    }
+    return cached->number;
+}
+
+void OrgQueryCache::clear() {
+    entries.clear();
+    slots.clear();
+    hand = 0;
+}
+
+size_t OrgQueryCache::size() const {
+    return entries.size();
+}
+
+size_t OrgQueryCache::getCapacity() const {
+    return capacity;
+}
+
+unsigned long long OrgQueryCache::getNumHits() const {
+    return numHits;
+}
+
+unsigned long long OrgQueryCache::getNumMisses() const {
+    return numMisses;
+}
+
+double OrgQueryCache::getHitRate() const {
+    unsigned long long numQueries = numHits + numMisses;
+    return (numQueries == 0) ? 0.0 : (double)numHits / numQueries;
+}
+
+unsigned long long OrgQueryCache::getNumEvictions() const {
+    return numEvictions;
+}
+
+unsigned long long OrgQueryCache::getNumInvalidations() const {
+    return numInvalidations;
+}
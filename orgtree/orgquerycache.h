@@ -0,0 +1,137 @@
+#ifndef ORGQUERYCACHE_H
+#define ORGQUERYCACHE_H
+
+#include <stddef.h>
+#include <unordered_map>
+#include <vector>
+
+#include "orgtree.h"
+#include "employeeindex.h"
+
+using namespace std;
+
+// A bounded cache of Orgtree query results for one organization chart.
+//
+// Charts shown in a UI get the same questions over and over, and every Orgtree query walks
+// the whole chart to answer them. The cache keeps up to a fixed number of results, keyed by
+// the query and its employee IDs, and answers repeated questions without walking the chart.
+//
+// Entries are replaced with the CLOCK algorithm: a hit only sets the entry's referenced bit,
+// and when the cache is full a hand sweeps the entries, clearing referenced bits, and reuses
+// the first entry whose bit was already clear. This keeps recently used results like LRU
+// does, without reordering a list on every hit.
+//
+// Results are tagged with the generation of the chart's EmployeeIndex, which advances when an
+// employee is added to or deleted from that chart. The first query after such a change empties
+// the cache, so a result is never served from a chart that has changed since, while changes to
+// other charts leave it alone. Caches on the same chart share its index. If the chart's changes
+// cannot be tracked, because only a part of it is indexed, no result is reused.
+class OrgQueryCache {
+
+public:
+    // Number of results kept when no capacity is given
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+private:
+    // Queries whose results are cached
+    enum Query { MANAGERS_OF_EMPLOYEE, CLOSEST_SHARED_MANAGER, NUM_OF_MANAGERS_BETWEEN };
+
+    struct Key {
+        int query;
+        int e1_id;
+        int e2_id;
+
+        bool operator==(const Key &other) const {
+            return query == other.query && e1_id == other.e1_id && e2_id == other.e2_id;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            unsigned long long h = (unsigned long long)(unsigned int)key.e1_id * 11400714819323198485ULL;
+            h ^= ((unsigned long long)(unsigned int)key.e2_id << 2 | (unsigned int)key.query) * 14029467366897019727ULL;
+            return (size_t)(h ^ (h >> 32));
+        }
+    };
+
+    // One cached result; only the fields of its query are used
+    struct Entry {
+        Key key;
+        bool referenced;        // used since the clock hand last passed
+        bool found;             // result of findManagersOfEmployee
+        vector<int> managers;   // managers found by findManagersOfEmployee
+        Employee* employee;     // result of findClosestSharedManager
+        int number;             // result of findNumOfManagersBetween
+    };
+
+    EmployeeIndex* index;                   // index of the chart, tracks its changes
+    bool acquired;                          // index taken with EmployeeIndex::acquire, released with the cache
+    bool tracked;                           // the index is attached, so its generation follows the chart
+    Employee* head;
+    size_t capacity;
+    vector<Entry> entries;                  // grows up to capacity, then entries are reused
+    unordered_map<Key, size_t, KeyHash> slots;   // index in entries of every cached key
+    size_t hand;                            // next entry the clock looks at
+    unsigned long long generation;          // index generation of the cached results
+
+    unsigned long long numHits;
+    unsigned long long numMisses;
+    unsigned long long numEvictions;
+    unsigned long long numInvalidations;
+
+    Entry* find(int query, int e1_id, int e2_id);
+    Entry& insert(int query, int e1_id, int e2_id);
+
+public:
+    /**
+     * Create an empty cache for the organization chart under head. The cache uses the
+     * EmployeeIndex already attached to the chart, which must then outlive the cache, or
+     * shares a new one with the other caches on the chart.
+     * The caller keeps ownership of the chart, and the cache must not be used after it is deleted.
+     *
+     * @param  head     the head / root Employee of the organization chart, may be nullptr
+     * @param  capacity maximum number of cached results, at least 1
+     */
+    explicit OrgQueryCache(Employee* head, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Create an empty cache for the chart of an existing EmployeeIndex, which must outlive the cache.
+     *
+     * @param  index    the index of the organization chart
+     * @param  capacity maximum number of cached results, at least 1
+     */
+    explicit OrgQueryCache(EmployeeIndex &index, size_t capacity = DEFAULT_CAPACITY);
+
+    ~OrgQueryCache();
+
+    OrgQueryCache(const OrgQueryCache &) = delete;
+    OrgQueryCache &operator=(const OrgQueryCache &) = delete;
+
+    // Same results as the Orgtree queries on head, cached
+    bool findManagersOfEmployee(int e_id, vector<int> &managers);
+    Employee* findClosestSharedManager(int e1_id, int e2_id);
+    int findNumOfManagersBetween(int e1_id, int e2_id);
+
+    // Drop every cached result, the counters are kept
+    void clear();
+
+    // Number of cached results, and the most that are kept
+    size_t size() const;
+    size_t getCapacity() const;
+
+    // Queries answered from the cache, and queries that walked the chart
+    unsigned long long getNumHits() const;
+    unsigned long long getNumMisses() const;
+
+    // Fraction of queries answered from the cache, 0 before the first query
+    double getHitRate() const;
+
+    // Results replaced to make room for new ones
+    unsigned long long getNumEvictions() const;
+
+    // Times the cache was emptied because the chart changed
+    unsigned long long getNumInvalidations() const;
+
+};
+
+#endif
@@ -0,0 +1,299 @@
+#include "orgsnapshot.h"
+
+#include <fcntl.h>      // open
+#include <limits.h>     // INT_MIN, INT_MAX
+#include <stdio.h>
+#include <string.h>     // memcpy, memcmp
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close
+
+const uint32_t OrgSnapshot::VERSION;
+const uint32_t OrgSnapshot::BYTE_ORDER_MARK;
+
+static const char SNAPSHOT_MAGIC[8] = { 'O', 'R', 'G', 'S', 'N', 'A', 'P', '\0' };
+
+OrgSnapshot::OrgSnapshot()
+    : mapped(nullptr), mappedSize(0), numEmployees(0),
+      ids(nullptr), parents(nullptr), depths(nullptr), childOffsets(nullptr),
+      children(nullptr), subtreeEnds(nullptr), slots(nullptr), slotMask(0), slotShift(64) {
+}
+
+OrgSnapshot::~OrgSnapshot() {
+    if (mapped != nullptr) {
+        munmap(mapped, mappedSize);
+    }
+}
+
+/**
+ * Checksum of a byte range, 8 bytes at a time. Every step is invertible, so changing any
+ * single word always changes the checksum.
+ */
+uint64_t OrgSnapshot::computeChecksum(const char* data, size_t length) {
+    const uint64_t MULTIPLIER = 11400714819323198485ULL;
+    uint64_t hash = length;
+
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * MULTIPLIER;
+        hash ^= hash >> 32;
+    }
+    for (; i < length; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * MULTIPLIER;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+// Bytes after the header for a chart of numEmployees employees
+uint64_t OrgSnapshot::payloadSizeFor(uint64_t numEmployees, uint64_t numSlots) {
+    uint64_t numChildren = (numEmployees > 0) ? numEmployees - 1 : 0;
+    uint64_t numInts = 4 * numEmployees + (numEmployees + 1) + numChildren;
+    return numInts * sizeof(int32_t) + numSlots * sizeof(Slot);
+}
+
+/**
+ * Write a snapshot of a flattened organization chart.
+ *
+ * <p>
+ * The payload is laid out in memory first, so its checksum can go into the header,
+ * and then the file is written with two writes.
+ *
+ * @param  org  the flattened organization chart
+ * @param  path path of the snapshot file to write
+ * @return   true if the snapshot was written
+ */
+bool OrgSnapshot::write(const FlatOrgtree &org, const string &path) {
+    int n = org.size();
+
+    // The ID table is kept at most half full, like IdHashMap
+    uint64_t numSlots = 16;
+    int shift = 60;
+    while (numSlots < 2 * (uint64_t)n) {
+        numSlots *= 2;
+        shift--;
+    }
+
+    vector<int32_t> ints;
+    ints.reserve(4 * (size_t)n + (size_t)n + 1 + (size_t)n);
+    for (int i = 0; i < n; i++) {
+        ints.push_back(org.getEmployeeID(i));
+    }
+    for (int i = 0; i < n; i++) {
+        ints.push_back(org.getManagerIndex(i));
+    }
+    for (int i = 0; i < n; i++) {
+        ints.push_back(org.getLevel(i));
+    }
+
+    // Direct report offsets, then the direct report lists themselves
+    int offset = 0;
+    ints.push_back(0);
+    for (int i = 0; i < n; i++) {
+        offset += org.getNumDirectReports(i);
+        ints.push_back(offset);
+    }
+    for (int i = 0; i < n; i++) {
+        ints.insert(ints.end(), org.directReportsBegin(i), org.directReportsEnd(i));
+    }
+    for (int i = 0; i < n; i++) {
+        ints.push_back(org.getSubtreeEnd(i));
+    }
+
+    // Linear probing from the Fibonacci hash of the ID, the same probe sequence indexOf follows.
+    // Empty slots are told apart by their index, so INT_MIN is a valid ID like any other
+    vector<Slot> table(numSlots);
+    for (size_t s = 0; s < table.size(); s++) {
+        table[s].key = INT_MIN;
+        table[s].index = FlatOrgtree::NO_INDEX;
+    }
+    for (int i = 0; i < n; i++) {
+        uint64_t s = ((uint64_t)(uint32_t)org.getEmployeeID(i) * 11400714819323198485ULL) >> shift;
+        while (table[s].index != FlatOrgtree::NO_INDEX) {
+            s = (s + 1) & (numSlots - 1);
+        }
+        table[s].key = org.getEmployeeID(i);
+        table[s].index = i;
+    }
+
+    vector<char> payload(ints.size() * sizeof(int32_t) + table.size() * sizeof(Slot));
+    memcpy(payload.data(), ints.data(), ints.size() * sizeof(int32_t));
+    memcpy(payload.data() + ints.size() * sizeof(int32_t), table.data(), table.size() * sizeof(Slot));
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.version = VERSION;
+    header.numEmployees = n;
+    header.numSlots = numSlots;
+    header.payloadSize = payload.size();
+    header.checksum = computeChecksum(payload.data(), payload.size());
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    return (fclose(file) == 0) && written;
+}
+
+/**
+ * Memory-map a snapshot file and point the arrays into the mapping.
+ *
+ * @param  path           path of the snapshot file
+ * @param  verifyChecksum true to reject corrupted contents, reading the whole file once
+ * @return   the opened snapshot, nullptr if the file is missing, truncated, corrupted, or of another version
+ */
+OrgSnapshot* OrgSnapshot::open(const string &path, bool verifyChecksum) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+    size_t fileSize = (size_t)info.st_size;
+
+    void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // The header must describe exactly the bytes that follow it
+    Header header;
+    memcpy(&header, mapped, sizeof(header));
+    const char* payload = (const char*)mapped + sizeof(Header);
+    bool valid = memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.byteOrder == BYTE_ORDER_MARK &&
+                 header.version == VERSION &&
+                 header.numEmployees <= (uint64_t)INT_MAX &&
+                 header.numSlots >= 16 && header.numSlots <= ((uint64_t)1 << 40) &&
+                 (header.numSlots & (header.numSlots - 1)) == 0 &&
+                 header.numSlots >= 2 * header.numEmployees &&
+                 header.payloadSize == payloadSizeFor(header.numEmployees, header.numSlots) &&
+                 header.payloadSize == fileSize - sizeof(Header);
+    if (valid && verifyChecksum) {
+        valid = computeChecksum(payload, header.payloadSize) == header.checksum;
+    }
+    if (!valid) {
+        munmap(mapped, fileSize);
+        return nullptr;
+    }
+
+    OrgSnapshot* snapshot = new OrgSnapshot();
+    snapshot->mapped = mapped;
+    snapshot->mappedSize = fileSize;
+
+    int n = (int)header.numEmployees;
+    const int32_t* ints = (const int32_t*)payload;
+    snapshot->numEmployees = n;
+    snapshot->ids = ints;
+    snapshot->parents = ints + n;
+    snapshot->depths = ints + 2 * (size_t)n;
+    snapshot->childOffsets = ints + 3 * (size_t)n;
+    snapshot->children = snapshot->childOffsets + n + 1;
+    snapshot->subtreeEnds = snapshot->children + (n > 0 ? n - 1 : 0);
+    snapshot->slots = (const Slot*)(snapshot->subtreeEnds + n);
+    snapshot->slotMask = header.numSlots - 1;
+    for (uint64_t s = header.numSlots; s > 1; s /= 2) {
+        snapshot->slotShift--;
+    }
+    return snapshot;
+}
+
+int OrgSnapshot::size() const {
+    return numEmployees;
+}
+
+int OrgSnapshot::indexOf(int e_id) const {
+    uint64_t s = ((uint64_t)(uint32_t)e_id * 11400714819323198485ULL) >> slotShift;
+    while (slots[s].index != FlatOrgtree::NO_INDEX) {
+        if (slots[s].key == e_id) {
+            return slots[s].index;
+        }
+        s = (s + 1) & slotMask;
+    }
+    return FlatOrgtree::NO_INDEX;
+}
+
+bool OrgSnapshot::isEmployeePresentInOrg(int e_id) const {
+    return indexOf(e_id) != FlatOrgtree::NO_INDEX;
+}
+
+bool OrgSnapshot::findManagersOfEmployee(int e_id, vector<int> &managers) const {
+    int index = indexOf(e_id);
+    if (index == FlatOrgtree::NO_INDEX) {
+        return false;
+    }
+    for (int manager = parents[index]; manager != FlatOrgtree::NO_INDEX; manager = parents[manager]) {
+        managers.push_back(ids[manager]);
+    }
+    return true;
+}
+
+int OrgSnapshot::findEmployeeLevel(int e_id, int headLevel) const {
+    int index = indexOf(e_id);
+    return (index == FlatOrgtree::NO_INDEX) ? Employee::NOT_FOUND : headLevel + depths[index];
+}
+
+/**
+ * Climb from e1 until its subtree interval holds e2: that manager is the closest shared one.
+ */
+int OrgSnapshot::findClosestSharedManagerIndex(int e1_index, int e2_index) const {
+    while (!(e1_index <= e2_index && e2_index < subtreeEnds[e1_index])) {
+        e1_index = parents[e1_index];
+    }
+    return e1_index;
+}
+
+int OrgSnapshot::findClosestSharedManager(int e1_id, int e2_id) const {
+    int e1_index = indexOf(e1_id);
+    int e2_index = indexOf(e2_id);
+
+    if (e1_index == FlatOrgtree::NO_INDEX && e2_index == FlatOrgtree::NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+    if (e2_index == FlatOrgtree::NO_INDEX) {
+        return e1_id;
+    }
+    if (e1_index == FlatOrgtree::NO_INDEX) {
+        return e2_id;
+    }
+    return ids[findClosestSharedManagerIndex(e1_index, e2_index)];
+}
+
+int OrgSnapshot::findNumOfManagersBetween(int e1_id, int e2_id) const {
+    int e1_index = indexOf(e1_id);
+    int e2_index = indexOf(e2_id);
+
+    if (e1_index == FlatOrgtree::NO_INDEX || e2_index == FlatOrgtree::NO_INDEX) {
+        return Employee::NOT_FOUND;
+    }
+
+    int sharedManager = findClosestSharedManagerIndex(e1_index, e2_index);
+    return (depths[e1_index] - depths[sharedManager]) +
+           (depths[e2_index] - depths[sharedManager]) - 1;
+}
+
+bool OrgSnapshot::isManagerOf(int m_id, int e_id) const {
+    int m_index = indexOf(m_id);
+    int e_index = indexOf(e_id);
+
+    if (m_index == FlatOrgtree::NO_INDEX || e_index == FlatOrgtree::NO_INDEX) {
+        return false;
+    }
+    return m_index < e_index && e_index < subtreeEnds[m_index];
+}
+
+int OrgSnapshot::findNumOfEmployeesUnder(int e_id) const {
+    int index = indexOf(e_id);
+    return (index == FlatOrgtree::NO_INDEX) ? Employee::NOT_FOUND : subtreeEnds[index] - index - 1;
+}
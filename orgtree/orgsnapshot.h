@@ -0,0 +1,117 @@
+#ifndef ORGSNAPSHOT_H
+#define ORGSNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "orgtree.h"
+#include "flatorgtree.h"
+
+using namespace std;
+
+// A read-only organization chart answering queries straight from a memory-mapped snapshot file.
+//
+// A snapshot holds the arrays of a FlatOrgtree (IDs, manager and level of every employee,
+// direct report offsets and lists, subtree ends) followed by an open-addressing table from
+// employee ID to index, so opening it needs no parsing and no per-employee allocation.
+// Every array is addressed by its offset from the start of the file, so the file can be
+// mapped anywhere.
+//
+// File layout, all integers in the byte order of the machine that wrote it:
+//   Header
+//   int32 ids[n], parents[n], depths[n], childOffsets[n + 1], children[n - 1 or 0], subtreeEnds[n]
+//   Slot  slots[numSlots]      pairs of (employee ID, index), (INT_MIN, -1) for an empty slot
+//
+// Opening always checks the magic, version, byte order and that the file size matches the
+// counts in the header, which catches truncated files. The checksum over everything after the
+// header catches corrupted contents, at the cost of reading the whole file once.
+class OrgSnapshot {
+
+public:
+    static const uint32_t VERSION = 1;
+
+private:
+    struct Header {
+        char magic[8];              // "ORGSNAP" and a zero byte
+        uint32_t byteOrder;         // BYTE_ORDER_MARK as written by the machine that wrote the file
+        uint32_t version;
+        uint64_t numEmployees;
+        uint64_t numSlots;          // power of two, at least twice numEmployees
+        uint64_t payloadSize;       // bytes after the header
+        uint64_t checksum;          // of the bytes after the header
+    };
+
+    struct Slot {
+        int32_t key;
+        int32_t index;
+    };
+
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    void* mapped;
+    size_t mappedSize;
+
+    int numEmployees;
+    const int32_t* ids;
+    const int32_t* parents;
+    const int32_t* depths;
+    const int32_t* childOffsets;
+    const int32_t* children;
+    const int32_t* subtreeEnds;
+    const Slot* slots;
+    uint64_t slotMask;
+    int slotShift;
+
+    OrgSnapshot();
+
+    static uint64_t computeChecksum(const char* data, size_t length);
+    static uint64_t payloadSizeFor(uint64_t numEmployees, uint64_t numSlots);
+    int findClosestSharedManagerIndex(int e1_index, int e2_index) const;
+
+public:
+    /**
+     * Write a snapshot of a flattened organization chart.
+     *
+     * @param  org  the flattened organization chart
+     * @param  path path of the snapshot file to write
+     * @return   true if the snapshot was written
+     */
+    static bool write(const FlatOrgtree &org, const string &path);
+
+    /**
+     * Memory-map a snapshot file.
+     *
+     * @param  path           path of the snapshot file
+     * @param  verifyChecksum true to read the whole file once and reject corrupted contents,
+     *                        false to only check the header and file size
+     * @return   the opened snapshot, to be deleted by the caller,
+     *           nullptr if the file cannot be mapped, is truncated, corrupted, or of another version
+     */
+    static OrgSnapshot* open(const string &path, bool verifyChecksum);
+
+    // Unmaps the file
+    ~OrgSnapshot();
+
+    OrgSnapshot(const OrgSnapshot&) = delete;
+    OrgSnapshot& operator=(const OrgSnapshot&) = delete;
+
+    // Number of employees in the chart
+    int size() const;
+
+    // Index of employee e_id in pre-order, FlatOrgtree::NO_INDEX if e_id is not present. O(1)
+    int indexOf(int e_id) const;
+
+    // Same results as the FlatOrgtree queries of the chart the snapshot was written from
+    bool isEmployeePresentInOrg(int e_id) const;
+    bool findManagersOfEmployee(int e_id, vector<int> &managers) const;
+    int findEmployeeLevel(int e_id, int headLevel) const;
+    int findClosestSharedManager(int e1_id, int e2_id) const;
+    int findNumOfManagersBetween(int e1_id, int e2_id) const;
+    bool isManagerOf(int m_id, int e_id) const;
+    int findNumOfEmployeesUnder(int e_id) const;
+
+};
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef ORGTRAVERSAL_H
+#define ORGTRAVERSAL_H
+
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+#include "orgtree.h"
+
+using namespace std;
+
+// The explicit stack of a traversal, kept per thread between calls, so a traversal only
+// allocates when its stack grows deeper than on any earlier call on the same thread.
+// Stacks that grew past MAX_KEPT_ENTRIES are released at the end of the call, so one very
+// deep chart does not hold on to its memory. A traversal started while another one with the
+// same type of entries is running on the thread, e.g. from inside a visitor, gets its own stack.
+template <typename T>
+class ScratchStack {
+
+private:
+    static const size_t MAX_KEPT_ENTRIES = 1 << 16;
+
+    struct ThreadStack {
+        vector<T> entries;
+        bool inUse;
+
+        ThreadStack() : inUse(false) {}
+    };
+
+    static ThreadStack& threadStack() {
+        static thread_local ThreadStack stack;
+        return stack;
+    }
+
+    vector<T> own;          // used when the thread's stack is taken by an enclosing traversal
+    vector<T>* entries;
+    bool shared;
+
+public:
+    ScratchStack() {
+        ThreadStack &stack = threadStack();
+        shared = !stack.inUse;
+        if (shared) {
+            stack.inUse = true;
+            entries = &stack.entries;
+            entries->clear();
+        }
+        else {
+            entries = &own;
+        }
+    }
+
+    ~ScratchStack() {
+        if (shared) {
+            if (entries->capacity() > MAX_KEPT_ENTRIES) {
+                vector<T>().swap(*entries);
+            }
+            threadStack().inUse = false;
+        }
+    }
+
+    ScratchStack(const ScratchStack&) = delete;
+    ScratchStack& operator=(const ScratchStack&) = delete;
+
+    vector<T>& get() {
+        return *entries;
+    }
+};
+
+// What a visitor tells the traversal to do next
+enum VisitResult {
+    CONTINUE,       // go on with the next employee
+    SKIP_SUBTREE,   // go on, but not below this employee (pre-order and level-order only)
+    STOP            // end the traversal now
+};
+
+// Pre-order, post-order and level-order traversals of an Employee tree.
+//
+// The visitor is any callable taking (Employee* employee, int level) and returning a
+// VisitResult, usually a lambda; it is a template parameter, so the compiler inlines it into
+// the traversal loop. The head is at level 0. Direct reports are visited in their order in
+// the chart, and nullptr direct reports are skipped. Every traversal walks the chart with an
+// explicit ScratchStack, so charts of any depth are supported without recursion.
+//
+// Each traversal returns false if the visitor stopped it, true if it visited everything.
+class OrgTraversal {
+
+public:
+    // Visit every employee before its direct reports
+    template <typename Visitor>
+    static bool preOrder(Employee* head, Visitor &&visit) {
+        if (head == nullptr) {
+            return true;
+        }
+
+        ScratchStack<pair<Employee*, int> > stack;
+        vector<pair<Employee*, int> > &toVisit = stack.get();
+        toVisit.push_back(make_pair(head, 0));
+        while (!toVisit.empty()) {
+            Employee* employee = toVisit.back().first;
+            int level = toVisit.back().second;
+            toVisit.pop_back();
+
+            VisitResult result = visit(employee, level);
+            if (result == STOP) {
+                return false;
+            }
+            if (result == SKIP_SUBTREE) {
+                continue;
+            }
+
+            // Push the direct reports in reverse, so that the first one is visited next
+            const vector<Employee*> &directReports = employee->getDirectReports();
+            for (size_t i = directReports.size(); i > 0; i--) {
+                if (directReports[i - 1] != nullptr) {
+                    toVisit.push_back(make_pair(directReports[i - 1], level + 1));
+                }
+            }
+        }
+        return true;
+    }
+
+    // Visit every employee after all its direct reports.
+    // The traversal never reads an employee again after visiting it, so the visitor may delete it.
+    template <typename Visitor>
+    static bool postOrder(Employee* head, Visitor &&visit) {
+        if (head == nullptr) {
+            return true;
+        }
+
+        // Path from the head to the current employee, each with the index of
+        // its next direct report to visit
+        ScratchStack<pair<Employee*, size_t> > stack;
+        vector<pair<Employee*, size_t> > &path = stack.get();
+        path.push_back(make_pair(head, (size_t)0));
+        while (!path.empty()) {
+            Employee* employee = path.back().first;
+            const vector<Employee*> &directReports = employee->getDirectReports();
+
+            if (path.back().second < directReports.size()) {
+                Employee* directReport = directReports[path.back().second++];
+                if (directReport != nullptr) {
+                    path.push_back(make_pair(directReport, (size_t)0));
+                }
+                continue;
+            }
+
+            path.pop_back();
+            if (visit(employee, (int)path.size()) == STOP) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Visit the employees level by level from the head down, each level in the order of the chart
+    template <typename Visitor>
+    static bool levelOrder(Employee* head, Visitor &&visit) {
+        if (head == nullptr) {
+            return true;
+        }
+
+        // The queue is a vector read from the front, its entries are never removed
+        ScratchStack<pair<Employee*, int> > stack;
+        vector<pair<Employee*, int> > &queue = stack.get();
+        queue.push_back(make_pair(head, 0));
+        for (size_t next = 0; next < queue.size(); next++) {
+            Employee* employee = queue[next].first;
+            int level = queue[next].second;
+
+            VisitResult result = visit(employee, level);
+            if (result == STOP) {
+                return false;
+            }
+            if (result == SKIP_SUBTREE) {
+                continue;
+            }
+
+            const vector<Employee*> &directReports = employee->getDirectReports();
+            for (size_t i = 0; i < directReports.size(); i++) {
+                if (directReports[i] != nullptr) {
+                    queue.push_back(make_pair(directReports[i], level + 1));
+                }
+            }
+        }
+        return true;
+    }
+
+};
+
+#endif
@@ -1,9 +1,49 @@
 #include <iostream>
 #include "orgtree.h"
+#include "employeeindex.h"
+#include "employeearena.h"
+#include "orgtraversal.h"
+#include "orgwriter.h"
+
+const int Employee::EMPTY_EMPLOYEEID;
+const int Employee::NOT_FOUND;
+
+/**
+ * Create a direct report of this employee.
+ *
+ * <p>
+ * The new employee is allocated from this employee's arena, if any, and linked to this
+ * employee as its manager. If the chart
+ * has an EmployeeIndex, the new employee is added to the index as well.
+ *
+ * @param  e_id the employee id of the new direct report
+ */
+void Employee::newDirectReport(int e_id) {
+    Employee* directReport = (this->arena != nullptr) ? this->arena->newEmployee(e_id) : new Employee(e_id);
+    directReport->manager = this;
+    if (this->index != nullptr) {
+        this->index->add(directReport);
+    }
+    this->directReports.push_back(directReport);
+}
+
+/**
+ * Remove the employee from the chart's index, if any, before it is deallocated.
+ */
+Employee::~Employee() {
+    if (this->index != nullptr) {
+        this->index->remove(this);
+    }
+}
 
 /**
  * Check if an employee is present in an organization chart.
  *
+ * <p>
+ * The chart is searched depth-first in pre-order with OrgTraversal, which walks it with an
+ * explicit stack instead of recursion, so a chart of any depth can be searched without
+ * overflowing the call stack.
+ *
  * @param  head the head / root Employee of the organization chart
  * @param  e_id the employee id being searched
  * @return      true or false
@@ -12,38 +52,21 @@
  */
 bool Orgtree::isEmployeePresentInOrg(Employee* head, int e_id) {
 
-    // Base case 1: Empty organization chart
-    // If the head is nullptr, there are no employees in the chart, so return false
-    if (head == nullptr) {
-        return false;
-    }
-
-    // Base case 2: Employee found
-    // If the employee ID of the current head matches the given ID, return true
-    if (head->getEmployeeID() == e_id) {
-        return true;
-    }
-
-    // Recursive case:
-    // Search for the employee in each subtree of the head
-
-    // Iterate through each direct report of the head
-    for (Employee* directReport : head->getDirectReports()) {
-        // Recursively call the function on each direct report
-        // If the employee is found in any of the child subtrees, return true
-
-        if (isEmployeePresentInOrg(directReport, e_id)) {
-            return true;  // employee found in one of the child subtrees
-        }
-    }
-
-    // If the employee is not found in any subtree, return false
-    return false;
+    // Stop at the employee with the given ID
+    // An empty chart, or a chart searched to the end without finding it, does not have the employee
+    return !OrgTraversal::preOrder(head, [e_id](Employee* employee, int level) {
+        return (employee->employeeID == e_id) ? STOP : CONTINUE;
+    });
 }
 
 /**
  * Find all managers of an employee.
  *
+ * <p>
+ * The chart is searched depth-first in pre-order, keeping the IDs on the path from the head
+ * to the current employee, one per level. When the employee is found, the path holds exactly
+ * its managers, which are added from the direct manager up to the head.
+ *
  * @param  head     the head / root Employee of the organization chart
  * @param  e_id     the employee id being searched
  * @param  managers a vector of ids of all managers in the ascending order
@@ -56,59 +79,25 @@ bool Orgtree::isEmployeePresentInOrg(Employee* head, int e_id) {
  */
 bool Orgtree::findManagersOfEmployee(Employee* head, int e_id, vector<int> &managers) {
 
-    // Recursive implementation to find the managers of an employee with the given ID
-
-    // Base case 1: Empty organization chart
-    // If the head is nullptr, there are no employees in the chart, so return false
-    if (head == nullptr) {
-        return false;
-    }
-
-    // Base case 2: Employee found
-    // If the employee ID of the current head matches the given ID, return true
-
-    if (head->getEmployeeID() == e_id) {
-        return true;
-    }
-
-    // Search subtrees from the head, after all subtrees are searched,
-    // if employee e_id is found:
-    // the head should be inserted to the managers vector along
-    // the backtracking process of recursive calls
-
-    // Note:
-    // do NOT add the employee's own e_id to the passed-in managers vector
-
-    // Flag to keep track of whether the employee is found in any child subtree
-    bool employeeFound = false;
-
-    // Recursive case:
-    // Search through the direct reports of the current head
-    for (Employee* directReport : head->getDirectReports()) {
-        // Recursively call the function on each direct report to search for the employee
-        if (findManagersOfEmployee(directReport, e_id, managers)) {
-            // If the employee is found in any of the child subtrees,
-            // add the current head (manager) to the managers vector before returning
-
-            // Check if the current head's ID is not equal to the employee's ID
-            // to avoid adding the employee's own ID to the vector
-            if (head->getEmployeeID() != e_id) {
-                managers.push_back(head->getEmployeeID());
-            }
-
-            // Set the flag to true since the employee is found in a child subtree
-            employeeFound = true;
-            break;  // Stop searching further as the employee is already found
+    // IDs from the head down to the current employee, one per level
+    ScratchStack<int> stack;
+    vector<int> &path = stack.get();
+
+    bool found = !OrgTraversal::preOrder(head, [e_id, &path](Employee* employee, int level) {
+        path.resize(level);
+        path.push_back(employee->employeeID);
+        return (employee->employeeID == e_id) ? STOP : CONTINUE;
+    });
+
+    // Everyone above the employee on the path is a manager, add them from the direct manager to the head
+    // Note: do NOT add the employee's own e_id to the managers vector
+    // If the employee was not found, the managers vector remains unchanged
+    if (found) {
+        for (size_t i = path.size() - 1; i > 0; i--) {
+            managers.push_back(path[i - 1]);
         }
     }
-
-    // Return the value of the employeeFound flag
-    // If the flag is true, it means that the employee with the given ID was found in one of the child subtrees,
-    // and the managers (including the current head) have been added to the managers vector.
-    // If the flag is false, it means that the employee was not found in any subtree.
-    // In this case, the managers vector remains unchanged.
-    return employeeFound;
-
+    return found;
 }
 
 /**
@@ -119,6 +108,10 @@ bool Orgtree::findManagersOfEmployee(Employee* head, int e_id, vector<int> &mana
  * a level of head plus 1, and so on and so forth...
  *
  * <p>
+ * The chart is searched depth-first in pre-order with OrgTraversal,
+ * which hands every employee to the search together with its level.
+ *
+ * <p>
  * Assumption: e_id is unique among all employee IDs
  *
  * @param  head      the head / root Employee of the organization chart
@@ -129,33 +122,31 @@ bool Orgtree::findManagersOfEmployee(Employee* head, int e_id, vector<int> &mana
  * @see
  */
 int Orgtree::findEmployeeLevel(Employee* head, int e_id, int headLevel) {
-    // Recursive implementation to find the level of an employee with the given ID
 
-    // Base case 1: Empty organization chart
-    if (head == nullptr) {
-        return Employee::NOT_FOUND;  // Employee not found, return NOT_FOUND constant
-    }
-
-    // Base case 2: Employee found
-    if (head->getEmployeeID() == e_id) {
-        return headLevel;  // Return the level of the employee
-    }
-
-    // Recursive case:
-    // Search for the employee in each subtree of the head
-    for (Employee* directReport : head->getDirectReports()) {
-        // Recursively call the function on each direct report, incrementing the level by 1
-
-        int employeeLevel = findEmployeeLevel(directReport, e_id, headLevel + 1);
-        if (employeeLevel != Employee::NOT_FOUND) {
-            return employeeLevel;  // Return the level of the employee if found in one of the child subtrees
+    // Employee not found, or empty organization chart: NOT_FOUND
+    int found = Employee::NOT_FOUND;
+    OrgTraversal::preOrder(head, [e_id, headLevel, &found](Employee* employee, int level) {
+        if (employee->employeeID == e_id) {
+            found = headLevel + level;  // The level of the employee, counted from the head's level
+            return STOP;
         }
-    }
-
-    // If the employee is not found in any subtree, return NOT_FOUND constant
-    return Employee::NOT_FOUND;
+        return CONTINUE;
+    });
+    return found;
 }
 
+// Search state of one employee in findClosestSharedManager,
+// what a recursive call would keep in its local variables
+struct SharedManagerFrame {
+    Employee* employee;     // the employee whose subtrees are being searched
+    size_t next;            // index of the next direct report to search
+    Employee* e1_manager;   // set when e1 is found in one of the subtrees
+    Employee* e2_manager;   // set when e2 is found in one of the subtrees
+
+    explicit SharedManagerFrame(Employee* employee)
+        : employee(employee), next(0), e1_manager(nullptr), e2_manager(nullptr) {}
+};
+
 /**
  * Find the closest shared manager of two employees e1 and e2.
  *
@@ -167,6 +158,11 @@ int Orgtree::findEmployeeLevel(Employee* head, int e_id, int headLevel) {
  * Employee 1 is a manager of employee 2 if employee 1 is an ancestor of employee 2 in the organization chart
  *
  * <p>
+ * The search runs the steps of the recursive search on an explicit stack of frames:
+ * searching a subtree pushes a frame, and finishing it pops the frame and hands
+ * its result to the frame of the manager below it.
+ *
+ * <p>
  * Assumption: e1_id and e2_id are unique among all employee IDs
  *
  * @param  head  the head / root Employee of the organization chart
@@ -185,80 +181,93 @@ int Orgtree::findEmployeeLevel(Employee* head, int e_id, int headLevel) {
  */
 Employee* Orgtree::findClosestSharedManager(Employee* head, int e1_id, int e2_id) {
 
-    // base case 1: empty organization chart
+    // empty organization chart
     if (head == nullptr) {
         return nullptr;  // If the head is nullptr, there are no employees in the chart, so return nullptr
     }
 
-    // base case 2: either e1_id or e2_id is the same as the head / root
-    if (head->getEmployeeID() == e1_id || head->getEmployeeID() == e2_id) {
+    // either e1_id or e2_id is the same as the head / root
+    if (head->employeeID == e1_id || head->employeeID == e2_id) {
         return head;  // Return the head / root if either e1_id or e2_id matches its employee ID
     }
 
-    // Recursively traverse through direct reports of the head to find
-    // where e1 and e2 are
-
     /*
-       For each recursive call (starting from the root), you need to handle three possible scenarios:
+       For each subtree (starting from the root), there are three possible scenarios:
        1) if e1 is found in one subtree, and e2 is found from another subtree;
-          the head at that recursive step would be the closest shared manager of e1 and e2.
-
-          you can use the returned pointer (being NOT NULL) from findClosestSharedManager
-          to see if e1 or e2 is found from a subtree (one of the base cases).
+          the employee owning the subtrees is the closest shared manager of e1 and e2.
 
        2) if either e1 or e2 is first found in one subtree (following one subtree),
           but the other employee is NOT found from any other subtree, then the found
           employee must either be the manager of the other employee, or the other employee
-          is NOT in the org chart; in either case, the first found employee should be
-          returned as the shared manager.
+          is NOT in the org chart; in either case, the first found employee is the result.
 
-       3) if neither e1 or e2 is found in the org chart, return nullptr
+       3) if neither e1 or e2 is found in the subtree, the result is nullptr
     */
-
-    // Initialize e1_manager and e2_manager pointer to nullptr
-    Employee* e1_manager = nullptr, *e2_manager = nullptr;
-
-    // Iterate through each direct report of the current head
-    for (Employee* directReport : head->getDirectReports()) {
-        // Recursively call findClosestSharedManager on each direct report
-        Employee* sharedManager = findClosestSharedManager(directReport, e1_id, e2_id);
-
-        // If a shared manager is found from the recursive call
-        if (sharedManager != nullptr) {
-            // Check if the shared manager is the same as e1_id
-            if (sharedManager->getEmployeeID() == e1_id) {
-                e1_manager = sharedManager; // Update e1_manager to the shared manager
+    ScratchStack<SharedManagerFrame> stack;
+    vector<SharedManagerFrame> &frames = stack.get();
+    frames.push_back(SharedManagerFrame(head));
+
+    while (true) {
+        SharedManagerFrame &frame = frames.back();
+        Employee* result;   // result of the subtree that was just searched
+
+        if (frame.next < frame.employee->directReports.size()) {
+            Employee* directReport = frame.employee->directReports[frame.next++];
+            if (directReport == nullptr) {
+                continue;
             }
 
-            // Check if the shared manager is the same as e2_id
-            else if (sharedManager->getEmployeeID() == e2_id) {
-                e2_manager = sharedManager; // Update e2_manager to the shared manager
+            // Neither e1 nor e2 is the direct report, search its subtrees
+            if (directReport->employeeID != e1_id && directReport->employeeID != e2_id) {
+                frames.push_back(SharedManagerFrame(directReport));
+                continue;
             }
 
-            // If e1 and e2 are found in different subtrees (different shared managers),
-            // return the shared manager as the closest shared manager of e1 and e2
-            else {
-                return sharedManager;
+            // e1 or e2 is the direct report itself, nothing below it needs to be searched
+            result = directReport;
+        }
+        else {
+            // All subtrees are searched, and e1 and e2 were not found in two different subtrees
+            // Return e1_manager or e2_manager if one of them is found (the other one is not), else nullptr
+            result = (frame.e1_manager != nullptr) ? frame.e1_manager : frame.e2_manager;
+            frames.pop_back();
+            if (frames.empty()) {
+                return result;
             }
         }
 
-        // Check if both e1_manager and e2_manager have been found
-        if (e1_manager && e2_manager) {
-            return head;  // Return the current head as the closest shared manager
-        }
-    }
+        // Hand the result to the manager's frame, which may finish its own search right away
+        while (result != nullptr) {
+            SharedManagerFrame &manager = frames.back();
 
-    // Check if e1_manager has been found
-    if (e1_manager) {
-        return e1_manager;  // Return e1_manager as the closest shared manager (e2 is not found)
-    }
+            if (result->employeeID == e1_id) {
+                manager.e1_manager = result;  // e1 is found in this subtree
+            }
+            else if (result->employeeID == e2_id) {
+                manager.e2_manager = result;  // e2 is found in this subtree
+            }
+            else {
+                // The closest shared manager was already found deeper in the subtree,
+                // pass it down to the head unchanged
+                frames.pop_back();
+                if (frames.empty()) {
+                    return result;
+                }
+                continue;
+            }
 
-    // Check if e2_manager has been found
-    if (e2_manager) {
-        return e2_manager;  // Return e2_manager as the closest shared manager (e1 is not found)
+            // e1 and e2 are found in different subtrees, so this employee is their closest shared manager
+            if (manager.e1_manager != nullptr && manager.e2_manager != nullptr) {
+                result = manager.employee;
+                frames.pop_back();
+                if (frames.empty()) {
+                    return result;
+                }
+                continue;
+            }
+            break;
+        }
     }
-
-    return nullptr;  // Neither e1 nor e2 is found, return nullptr
 }
 
 /**
@@ -281,10 +290,6 @@ Employee* Orgtree::findClosestSharedManager(Employee* head, int e1_id, int e2_id
  */
 int Orgtree::findNumOfManagersBetween(Employee* head, int e1_id, int e2_id) {
 
-    // Indirectly uses recursion through the functions it calls (isEmployeePresentInOrg, findClosestSharedManager, and findEmployeeLevel).
-    // These functions use recursion internally to traverse the organization hierarchy and perform the required operations
-
-
     // Continue only if both employee nodes e1_id and e2_id are in the org chart tree
     // otherwise, return Employee::NOT_FOUND
     if (!isEmployeePresentInOrg(head, e1_id) || !isEmployeePresentInOrg(head, e2_id)) {
@@ -310,22 +315,25 @@ int Orgtree::findNumOfManagersBetween(Employee* head, int e1_id, int e2_id) {
 
 }
 
-/** Recursively delete a tree
+/** Delete a tree
  *  The proper implementation of this function is also needed for
  *  passing the valgrind memory leaking test.
  *
  * <p>
- * Traversing from the head / root node, recursively deallocate
- * the memory of the descendants from the leaf node level.
+ * Traversing from the head / root node, deallocate the memory of
+ * the descendants from the leaf node level.
  *
  * DO NOT worry about removing them from the vector directReports
  *
  * Use post order traversal:
- * Delete / deallocate the children recursively
+ * Delete / deallocate the children first
  * Delete / deallocate the current node after deleting its children
  *     Before deleting the current node, print its employee ID and a new line
  *     This part will be autograded as well as manually inspected for grading
  *
+ * The work is done by deleteOrgtree(head, &cout) below, which walks the chart with
+ * OrgTraversal::postOrder, so charts of any depth are deleted in the same order without recursion.
+ *
  * For example, with the following org chart, the post order traversal
  * order would be 5 6 2 7 8 3 1, and the nodes should be deleted in that order
  *             1
@@ -340,22 +348,61 @@ int Orgtree::findNumOfManagersBetween(Employee* head, int e1_id, int e2_id) {
  * @see
  */
 void Orgtree::deleteOrgtree(Employee* head) {
-    // Recursive implementation to delete the entire organization tree
+    // The trace is buffered and flushed once, instead of once per employee
+    deleteOrgtree(head, &cout);
+}
 
-    // Base case: empty tree or organization chart
+/**
+ * Delete a tree in post order, writing one line per deleted employee to trace.
+ *
+ * <p>
+ * The chart is walked with OrgTraversal::postOrder, and the trace is formatted with an OrgWriter.
+ * Employees allocated with new are deleted, and employees allocated from an EmployeeArena
+ * are returned to it.
+ *
+ * @param  head  the head / root Employee of the organization chart
+ * @param  trace the stream receiving one line per deleted employee, nullptr to delete quietly
+ * @return   None
+ */
+void Orgtree::deleteOrgtree(Employee* head, ostream* trace) {
+
+    // Empty tree or organization chart
     if (head == nullptr) {
         return;  // No employees to delete, so return
     }
 
-    // Delete children recursively
-    // Traverse through each direct report of the current head node
-    for (Employee* directReport : head->getDirectReports()) {
-        deleteOrgtree(directReport);  // Recursively delete all child subtrees
+    // Employees allocated from an arena are returned to it
+    auto deleteEmployee = [](Employee* employee) {
+        if (employee->arena != nullptr) {
+            employee->arena->deleteEmployee(employee);
+        }
+        else {
+            delete employee;
+        }
+    };
+
+    // Post order: the direct reports are deleted before the current node
+    if (trace == nullptr) {
+        OrgTraversal::postOrder(head, [&deleteEmployee](Employee* employee, int level) {
+            deleteEmployee(employee);
+            return CONTINUE;
+        });
+        return;
     }
 
-    // Print the employee ID of the current node before deleting
-    cout << "Deleting employee with ID: " << head->getEmployeeID() << endl;
-
-    // Delete the current node after deleting its children
-    delete head;
+    // The trace lines are formatted into a buffer and handed to the stream in large blocks.
+    // The writer flushes the rest of the trace when it goes out of scope.
+    StreamSink sink(*trace);
+    OrgWriter writer(sink);
+    OrgTraversal::postOrder(head, [&writer, &deleteEmployee](Employee* employee, int level) {
+
+        // Print the employee ID of the current node before deleting
+        static const char PREFIX[] = "Deleting employee with ID: ";
+        writer.write(PREFIX, sizeof(PREFIX) - 1);
+        writer.writeInt(employee->employeeID);
+        writer.writeChar('\n');
+
+        deleteEmployee(employee);
+        return CONTINUE;
+    });
 }
@@ -3,6 +3,7 @@
 
 #include <ctype.h>  // character manipualtion, e.g. tolower()
 #include <stdio.h>
+#include <iosfwd>   // ostream
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -10,12 +11,28 @@
 
 using namespace std;
 
+class EmployeeIndex;
+class EmployeeArena;
+
 // An employee class to store an organization chart (tree) node
 class Employee {
 
 private:
     int employeeID;
     vector<Employee*> directReports; // children - direct reports
+    Employee* manager;               // parent - direct manager, nullptr for the head
+    EmployeeIndex* index;            // index of the chart this employee belongs to, if any
+    EmployeeArena* arena;            // arena the employee was allocated from, nullptr if allocated with new
+    long long attribute;             // numeric payload, e.g. a budget or an approval limit, 0 by default
+
+    // Create a direct report in this employee's arena (or with new), link it to this employee
+    // and register it with the chart's index
+    void newDirectReport(int e_id);
+
+    friend class EmployeeIndex;
+    friend class EmployeeArena;
+    friend class Orgtree;           // traversals read the direct reports in place
+    friend class ParallelOrgtree;
 
 public:
     // -1 employee ID indicate an empty Employee ID
@@ -27,33 +44,61 @@ public:
     // default constructor
     Employee() {
         this -> employeeID = EMPTY_EMPLOYEEID;
+        this -> manager = nullptr;
+        this -> index = nullptr;
+        this -> arena = nullptr;
+        this -> attribute = 0;
     }
 
     // Constructor for instantiating an employee instance with an employee id.
     // Assume employee ID argument is unique among all employee IDs.
     Employee(int id) {
         this -> employeeID = id;
+        this -> manager = nullptr;
+        this -> index = nullptr;
+        this -> arena = nullptr;
+        this -> attribute = 0;
     }
 
     // Constructor for instantiating an employee instance with an employee id
     // and all direct reports to this employee.
-    Employee(int id, vector<int> dReports) {
+    Employee(int id, const vector<int> &dReports) {
         this -> employeeID = id;
-        for (int d : dReports) {
-            this -> directReports.push_back(new Employee(d));
-        }
+        this -> manager = nullptr;
+        this -> index = nullptr;
+        this -> arena = nullptr;
+        this -> attribute = 0;
+        addDirectReports(dReports);
     }
 
+    // Removes the employee from the chart's index, if any.
+    // Direct reports are NOT deleted, use Orgtree::deleteOrgtree to delete the org tree
+    // See below
+    ~Employee();
+
     //Add a direct report to the employee
     //Assume employee ID argument is unique among all employee IDs.
     void addDirectReport(int e_id) {
-        this -> directReports.push_back(new Employee(e_id));
+        newDirectReport(e_id);
     }
 
     //Add a group of direct reports to the employee
-    void addDirectReports(vector<int> dReports) {
-        for (int d : dReports) {
-            this -> directReports.push_back(new Employee(d));
+    void addDirectReports(const vector<int> &dReports) {
+        // Grow at least geometrically, so adding reports in small batches stays linear
+        size_t needed = this -> directReports.size() + dReports.size();
+        if (needed > this -> directReports.capacity()) {
+            this -> directReports.reserve(needed > 2 * this -> directReports.capacity()
+                                          ? needed : 2 * this -> directReports.capacity());
+        }
+        addDirectReports(dReports.begin(), dReports.end());
+    }
+
+    //Add the direct reports with the IDs in first .. last, e.g. a part of a larger vector or array,
+    //without copying them into a vector first
+    template <typename Iterator>
+    void addDirectReports(Iterator first, Iterator last) {
+        for (; first != last; ++first) {
+            newDirectReport(*first);
         }
     }
 
@@ -62,16 +107,31 @@ public:
         return this -> employeeID;
     }
 
-    vector<Employee*> getDirectReports() {
+    // The direct reports in place, without copying the list.
+    // The reference stays valid until direct reports are added to this employee.
+    const vector<Employee*>& getDirectReports() {
         return this -> directReports;
     }
 
-    // No destructor here
-    // Use a recursive function to delete the org tree
-    // See below
+    // Direct manager of the employee, nullptr for the head of the chart
+    Employee* getManager() {
+        return this -> manager;
+    }
+
+    // Numeric attribute of the employee, aggregated along management chains by OrgPathIndex
+    long long getAttribute() {
+        return this -> attribute;
+    }
+
+    void setAttribute(long long value) {
+        this -> attribute = value;
+    }
 
 };
 
+// Queries over an organization chart (tree).
+// Every function walks the chart with an explicit stack instead of recursion, most of them
+// through OrgTraversal, so charts of any depth are supported without overflowing the call stack.
 class Orgtree {
 
 public:
@@ -168,18 +228,18 @@ public:
      */
     static int findNumOfManagersBetween(Employee* head, int e1_id, int e2_id);
 
-    /** Recursively delete a tree
+    /** Delete a tree, without recursion
      *  The proper implementation of this function is also needed for
      *  passing the valgrind memory leaking test.
      *
      * <p>
-     * Traversing from the head / root node, recursively deallocate
-     * the memory of the descendants from the leaf node level.
+     * Traversing from the head / root node, deallocate the memory of
+     * the descendants from the leaf node level.
      *
      * DO NOT worry about removing them from the vector directReports
      *
      * Use post order traversal:
-     * Delete / deallocate the children recursively
+     * Delete / deallocate the children first
      * Delete / deallocate the current node after deleting its children
      *     Before deleting the current node, print its employee ID and a new line
      *     The print here is for verifying the order of the deletion
@@ -193,6 +253,9 @@ public:
      *          / \  / \
      *          5 6  7 8
      *
+     * The trace goes to cout with one flush at the end, instead of one per employee.
+     * Employees allocated from an EmployeeArena are returned to their arena.
+     *
      * @param  head  the head / root Employee of the organization chart
      * @return   None
      *
@@ -200,6 +263,15 @@ public:
      */
     static void deleteOrgtree(Employee* head);
 
+    /**
+     * Delete a tree in the same post order as above, writing the deletion trace to any stream.
+     *
+     * @param  head  the head / root Employee of the organization chart
+     * @param  trace the stream receiving one line per deleted employee, nullptr to delete quietly
+     * @return   None
+     */
+    static void deleteOrgtree(Employee* head, ostream* trace);
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "orgwriter.h"
+
+#include <ostream>
+
+const size_t OrgWriter::DEFAULT_CAPACITY;
+
+void MemorySink::write(const char* data, size_t size) {
+    contents.append(data, size);
+}
+
+const string& MemorySink::getContents() const {
+    return contents;
+}
+
+FileSink::FileSink(FILE* file) : file(file), owned(false), good(file != nullptr) {
+}
+
+FileSink::FileSink(const string &path) : file(fopen(path.c_str(), "wb")), owned(true), good(file != nullptr) {
+}
+
+FileSink::~FileSink() {
+    if (owned && file != nullptr) {
+        fclose(file);
+    }
+}
+
+void FileSink::write(const char* data, size_t size) {
+    good = good && fwrite(data, 1, size, file) == size;
+}
+
+void FileSink::flush() {
+    good = good && fflush(file) == 0;
+}
+
+bool FileSink::isGood() const {
+    return good;
+}
+
+StreamSink::StreamSink(ostream &stream) : stream(stream) {
+}
+
+void StreamSink::write(const char* data, size_t size) {
+    stream.write(data, (streamsize)size);
+}
+
+void StreamSink::flush() {
+    stream.flush();
+}
+
+bool StreamSink::isGood() const {
+    return stream.good();
+}
+
+OrgWriter::OrgWriter(OrgSink &sink, size_t capacity)
+    : sink(sink), buffer(capacity > 32 ? capacity : 32), used(0) {
+}
+
+OrgWriter::~OrgWriter() {
+    flush();
+}
+
+void OrgWriter::drain() {
+    if (used > 0) {
+        sink.write(buffer.data(), used);
+        used = 0;
+    }
+}
+
+void OrgWriter::flush() {
+    drain();
+    sink.flush();
+}
+
+bool OrgWriter::isGood() const {
+    return sink.isGood();
+}
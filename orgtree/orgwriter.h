@@ -0,0 +1,164 @@
+#ifndef ORGWRITER_H
+#define ORGWRITER_H
+
+#include <iosfwd>   // ostream
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Destination of the text written by an OrgWriter, handed over in large blocks
+class OrgSink {
+
+public:
+    virtual ~OrgSink() {}
+
+    // Take size bytes of output
+    virtual void write(const char* data, size_t size) = 0;
+
+    // Push everything taken so far to the destination
+    virtual void flush() {}
+
+    // false once a write to the destination failed
+    virtual bool isGood() const {
+        return true;
+    }
+
+};
+
+// Keeps the output in memory
+class MemorySink : public OrgSink {
+
+private:
+    string contents;
+
+public:
+    void write(const char* data, size_t size);
+
+    const string& getContents() const;
+
+};
+
+// Writes to a C stream: a file opened by the sink, or one opened by the caller such as stdout
+class FileSink : public OrgSink {
+
+private:
+    FILE* file;
+    bool owned;     // opened by the sink, and closed with it
+    bool good;
+
+public:
+    // Write to an open stream, e.g. stdout, which the caller keeps open
+    explicit FileSink(FILE* file);
+
+    // Create or truncate a file, check isGood() to see if it could be opened
+    explicit FileSink(const string &path);
+
+    ~FileSink();
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    void write(const char* data, size_t size);
+    void flush();
+    bool isGood() const;
+
+};
+
+// Writes to a C++ stream, e.g. cout or a stringstream
+class StreamSink : public OrgSink {
+
+private:
+    ostream &stream;
+
+public:
+    explicit StreamSink(ostream &stream);
+
+    void write(const char* data, size_t size);
+    void flush();
+    bool isGood() const;
+
+};
+
+// Formats text into a fixed buffer and hands it to a sink one full buffer at a time, so
+// writing a line per employee costs a few stores instead of a stream operation or a system
+// call. The formatting functions are inline, and only a full buffer calls the sink.
+// The buffer is flushed when the writer is destroyed.
+class OrgWriter {
+
+public:
+    // Bytes buffered before they are handed to the sink
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+private:
+    OrgSink &sink;
+    vector<char> buffer;
+    size_t used;
+
+    // Hand the buffered bytes to the sink, without flushing the sink
+    void drain();
+
+public:
+    explicit OrgWriter(OrgSink &sink, size_t capacity = DEFAULT_CAPACITY);
+    ~OrgWriter();
+
+    OrgWriter(const OrgWriter&) = delete;
+    OrgWriter& operator=(const OrgWriter&) = delete;
+
+    void write(const char* data, size_t size) {
+        if (size > buffer.size() - used) {
+            drain();
+            if (size > buffer.size()) {
+                sink.write(data, size);
+                return;
+            }
+        }
+        for (size_t i = 0; i < size; i++) {
+            buffer[used + i] = data[i];
+        }
+        used += size;
+    }
+
+    void write(const string &text) {
+        write(text.data(), text.size());
+    }
+
+    void writeChar(char c) {
+        if (used == buffer.size()) {
+            drain();
+        }
+        buffer[used++] = c;
+    }
+
+    // Write a number in decimal
+    void writeInt(long long value) {
+        char digits[20];
+        int numDigits = 0;
+        unsigned long long magnitude = (value < 0) ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+        do {
+            digits[numDigits++] = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude > 0);
+
+        if (buffer.size() - used < 21) {
+            drain();
+        }
+        if (value < 0) {
+            buffer[used++] = '-';
+        }
+        while (numDigits > 0) {
+            buffer[used++] = digits[--numDigits];
+        }
+    }
+
+    // Hand everything written so far to the sink, and flush the sink
+    void flush();
+
+    // false once the sink failed to write
+    bool isGood() const;
+
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "parallelorgtree.h"
+
+#include <algorithm>  // max
+
+const int ParallelOrgtree::DEFAULT_GRAIN_SIZE;
+
+ParallelOrgtree::ParallelOrgtree(int numThreads, int grainSize)
+    : numThreads(numThreads > 0 ? numThreads : max(1, (int)thread::hardware_concurrency())),
+      grainSize(max(1, grainSize)),
+      queues(this->numThreads),
+      pendingTasks(0), stopped(false),
+      jobNumber(0), busyWorkers(0), exiting(false) {
+
+    for (int w = 1; w < this->numThreads; w++) {
+        workers.push_back(thread(&ParallelOrgtree::poolThread, this, w));
+    }
+}
+
+ParallelOrgtree::~ParallelOrgtree() {
+    {
+        lock_guard<mutex> pool(poolLock);
+        exiting = true;
+    }
+    jobReady.notify_all();
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+}
+
+int ParallelOrgtree::getNumThreads() const {
+    return numThreads;
+}
+
+/**
+ * Main loop of a pool thread: wait for the next traversal, run it, and report back.
+ */
+void ParallelOrgtree::poolThread(int worker) {
+    unsigned long lastJob = 0;
+
+    while (true) {
+        unique_lock<mutex> pool(poolLock);
+        jobReady.wait(pool, [&]() {
+            return exiting || jobNumber != lastJob;
+        });
+        if (exiting) {
+            return;
+        }
+        lastJob = jobNumber;
+        pool.unlock();
+
+        job(worker);
+
+        pool.lock();
+        if (--busyWorkers == 0) {
+            jobDone.notify_one();
+        }
+    }
+}
+
+/**
+ * Run a traversal on every worker, the caller as worker 0, and wait for all of them.
+ */
+void ParallelOrgtree::runJob(const function<void(int)> &traversal) {
+    {
+        lock_guard<mutex> pool(poolLock);
+        job = traversal;
+        busyWorkers = numThreads - 1;
+        jobNumber++;
+    }
+    jobReady.notify_all();
+
+    traversal(0);
+
+    unique_lock<mutex> pool(poolLock);
+    jobDone.wait(pool, [&]() {
+        return busyWorkers == 0;
+    });
+    job = nullptr;
+}
+
+/**
+ * Take the newest task of the worker's own queue, or else steal the oldest task of another worker.
+ *
+ * @return  false if no queue had a task
+ */
+bool ParallelOrgtree::takeTask(int worker, Task &task) {
+    {
+        lock_guard<mutex> own(queues[worker].lock);
+        if (!queues[worker].tasks.empty()) {
+            task = queues[worker].tasks.back();
+            queues[worker].tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (int i = 1; i < numThreads; i++) {
+        TaskQueue &victim = queues[(worker + i) % numThreads];
+        lock_guard<mutex> other(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Move all but the top of the worker's local stack into its queue, where other workers can steal them.
+ * The bottom of the stack holds the shallowest, so largest, subtrees, and they go to the front.
+ */
+void ParallelOrgtree::shareTasks(int worker, vector<Task> &local) {
+    if (local.size() < 2) {
+        return;
+    }
+
+    // Count the tasks before they are visible, so the traversal never looks finished too early
+    size_t numShared = local.size() - 1;
+    pendingTasks.fetch_add((long)numShared);
+
+    lock_guard<mutex> own(queues[worker].lock);
+    queues[worker].tasks.insert(queues[worker].tasks.end(), local.begin(), local.begin() + numShared);
+    local.erase(local.begin(), local.begin() + numShared);
+}
+
+/**
+ * Find employees e1 and e2 in one traversal, stopping as soon as both are found.
+ * e1 or e2 is set to nullptr if that employee is not present.
+ */
+void ParallelOrgtree::findEmployees(Employee* head, int e1_id, int e2_id, Employee* &e1, Employee* &e2) {
+    atomic<Employee*> found1(nullptr), found2(nullptr);
+
+    traverse(head, 0, [&](int worker, Employee* employee, int level) {
+        if (employee->getEmployeeID() == e1_id) {
+            found1.store(employee);
+        }
+        if (employee->getEmployeeID() == e2_id) {
+            found2.store(employee);
+        }
+        return found1.load() != nullptr && found2.load() != nullptr;
+    });
+
+    e1 = found1.load();
+    e2 = found2.load();
+}
+
+bool ParallelOrgtree::isEmployeePresentInOrg(Employee* head, int e_id) {
+    Employee* employee;
+    findEmployees(head, e_id, e_id, employee, employee);
+    return employee != nullptr;
+}
+
+bool ParallelOrgtree::findManagersOfEmployee(Employee* head, int e_id, vector<int> &managers) {
+    Employee* employee;
+    findEmployees(head, e_id, e_id, employee, employee);
+    if (employee == nullptr) {
+        return false;
+    }
+
+    // Follow the managers up to the head of the searched chart
+    for (Employee* e = employee; e != head; ) {
+        e = e->getManager();
+        managers.push_back(e->getEmployeeID());
+    }
+    return true;
+}
+
+int ParallelOrgtree::findEmployeeLevel(Employee* head, int e_id, int headLevel) {
+    atomic<int> foundLevel(Employee::NOT_FOUND);
+
+    traverse(head, headLevel, [&](int worker, Employee* employee, int level) {
+        if (employee->getEmployeeID() != e_id) {
+            return false;
+        }
+        foundLevel.store(level);
+        return true;
+    });
+    return foundLevel.load();
+}
+
+/**
+ * Number of management levels between employee and head, which is one of its managers or itself.
+ */
+int ParallelOrgtree::levelsBelow(Employee* employee, Employee* head) {
+    int levels = 0;
+    for (; employee != head; employee = employee->getManager()) {
+        levels++;
+    }
+    return levels;
+}
+
+/**
+ * Closest shared manager of two employees of the chart under head: climb from the deeper
+ * employee until both are on the same level, then climb together until they meet.
+ */
+Employee* ParallelOrgtree::sharedManagerOf(Employee* head, Employee* e1, Employee* e2) {
+    int e1_level = levelsBelow(e1, head);
+    int e2_level = levelsBelow(e2, head);
+
+    for (; e1_level > e2_level; e1_level--) {
+        e1 = e1->getManager();
+    }
+    for (; e2_level > e1_level; e2_level--) {
+        e2 = e2->getManager();
+    }
+    while (e1 != e2) {
+        e1 = e1->getManager();
+        e2 = e2->getManager();
+    }
+    return e1;
+}
+
+Employee* ParallelOrgtree::findClosestSharedManager(Employee* head, int e1_id, int e2_id) {
+    Employee* e1;
+    Employee* e2;
+    findEmployees(head, e1_id, e2_id, e1, e2);
+    if (e1 == nullptr || e2 == nullptr) {
+        return (e1 != nullptr) ? e1 : e2;
+    }
+    return sharedManagerOf(head, e1, e2);
+}
+
+int ParallelOrgtree::findNumOfManagersBetween(Employee* head, int e1_id, int e2_id) {
+    Employee* e1;
+    Employee* e2;
+    findEmployees(head, e1_id, e2_id, e1, e2);
+    if (e1 == nullptr || e2 == nullptr) {
+        return Employee::NOT_FOUND;
+    }
+
+    Employee* sharedManager = sharedManagerOf(head, e1, e2);
+    return levelsBelow(e1, sharedManager) + levelsBelow(e2, sharedManager) - 1;
+}
+
+long long ParallelOrgtree::countEmployees(Employee* head) {
+    return reduce(head, 0, 0LL,
+                  [](Employee* employee, int level) { return 1LL; },
+                  [](long long a, long long b) { return a + b; });
+}
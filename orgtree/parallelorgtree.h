@@ -0,0 +1,289 @@
+#ifndef PARALLELORGTREE_H
+#define PARALLELORGTREE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "orgtree.h"
+
+using namespace std;
+
+// Org-wide searches and aggregations on a work-stealing thread pool.
+//
+// A traversal starts with the head as the only task. Every worker walks its task depth-first
+// with a local stack; after each grainSize employees it moves all but the deepest pending
+// subtree of its stack into its own task queue, so subtrees smaller than grainSize are always
+// walked serially. Workers take their own newest tasks first and, when they run out, steal the
+// oldest (shallowest, so largest) tasks of the other workers.
+//
+// Searches stop every worker as soon as the employee is found, and reduce() combines one
+// partial result per worker. The calling thread works as worker 0 of every traversal, and
+// one traversal runs at a time on a pool.
+class ParallelOrgtree {
+
+public:
+    // Number of employees a worker walks before sharing the rest of its subtree
+    static const int DEFAULT_GRAIN_SIZE = 1024;
+
+private:
+    // A subtree still to be walked, with the level of its head
+    struct Task {
+        Employee* employee;
+        int level;
+    };
+
+    // The task queue of one worker, the owner works at the back and thieves steal at the front
+    struct TaskQueue {
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    // One partial result per worker, padded so workers do not share cache lines
+    template <typename T>
+    struct Partial {
+        T value;
+        char padding[64];
+    };
+
+    int numThreads;
+    int grainSize;
+    vector<TaskQueue> queues;
+    vector<thread> workers;             // numThreads - 1 pool threads, the caller is worker 0
+
+    atomic<long> pendingTasks;          // tasks queued or being walked in the current traversal
+    atomic<bool> stopped;               // set when a search finds its employee
+
+    mutex poolLock;
+    condition_variable jobReady;        // signals the pool threads to start a traversal or to exit
+    condition_variable jobDone;         // signals the caller that all pool threads are done
+    function<void(int)> job;            // traversal run by every worker, with the worker number
+    unsigned long jobNumber;            // counts traversals, so every pool thread runs each one once
+    int busyWorkers;                    // pool threads still running the current traversal
+    bool exiting;
+
+    mutex traversalLock;                // one traversal at a time
+
+    void poolThread(int worker);
+    void runJob(const function<void(int)> &traversal);
+    bool takeTask(int worker, Task &task);
+    void shareTasks(int worker, vector<Task> &local);
+
+    template <typename Visit>
+    void walk(int worker, Visit &visit);
+
+    template <typename Visit>
+    void traverse(Employee* head, int headLevel, Visit visit);
+
+    void findEmployees(Employee* head, int e1_id, int e2_id, Employee* &e1, Employee* &e2);
+    static int levelsBelow(Employee* employee, Employee* head);
+    static Employee* sharedManagerOf(Employee* head, Employee* e1, Employee* e2);
+
+public:
+    /**
+     * Start the pool threads.
+     *
+     * @param  numThreads number of workers including the caller, 0 to use one per core
+     * @param  grainSize  number of employees a worker walks before sharing work, at least 1
+     */
+    explicit ParallelOrgtree(int numThreads, int grainSize = DEFAULT_GRAIN_SIZE);
+
+    // Stop and join the pool threads
+    ~ParallelOrgtree();
+
+    ParallelOrgtree(const ParallelOrgtree&) = delete;
+    ParallelOrgtree& operator=(const ParallelOrgtree&) = delete;
+
+    // Number of workers, including the calling thread
+    int getNumThreads() const;
+
+    /**
+     * Check if an employee is present in an organization chart.
+     * Same result as Orgtree::isEmployeePresentInOrg.
+     *
+     * @param  head the head / root Employee of the organization chart
+     * @param  e_id the employee id being searched
+     * @return      true or false
+     */
+    bool isEmployeePresentInOrg(Employee* head, int e_id);
+
+    /**
+     * Find all managers of an employee, by finding the employee and following its managers up to head.
+     * Same result as Orgtree::findManagersOfEmployee.
+     *
+     * @param  head     the head / root Employee of the organization chart
+     * @param  e_id     the employee id being searched
+     * @param  managers a vector of ids of all managers in the ascending order
+     *                  of their tree height, from the direct manager to the head
+     * @return          is employee found
+     */
+    bool findManagersOfEmployee(Employee* head, int e_id, vector<int> &managers);
+
+    /**
+     * Find the level of an employee in an organization chart.
+     * Same result as Orgtree::findEmployeeLevel.
+     *
+     * @param  head      the head / root Employee of the organization chart
+     * @param  e_id      the employee id being searched
+     * @param  headLevel the level of the head employee of the organization
+     * @return  level of the employee in the org chart
+     *          returns Employee::NOT_FOUND if e_id is not present or head is nullptr
+     */
+    int findEmployeeLevel(Employee* head, int e_id, int headLevel);
+
+    /**
+     * Find the closest shared manager of two employees e1 and e2, by finding both in one
+     * traversal and following their managers up to the first shared one.
+     * Same result as Orgtree::findClosestSharedManager.
+     *
+     * @param  head  the head / root Employee of the organization chart
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   closest shared manager in the org chart between employee e1 and employee e2
+     *           if head is nullptr or neither e1 or e2 is present, returns nullptr
+     *           if only one of e1 and e2 is present, returns the one that is present
+     */
+    Employee* findClosestSharedManager(Employee* head, int e1_id, int e2_id);
+
+    /**
+     * Calculate the number of managers between employee e1 and employee e2.
+     * Same result as Orgtree::findNumOfManagersBetween.
+     *
+     * @param  head  the head / root Employee of the organization chart
+     * @param  e1_id id of employee 1 being searched
+     * @param  e2_id id of employee 2 being searched
+     * @return   number of managers between employee e1 and employee e2
+     *           returns Employee::NOT_FOUND if either e1 or e2 is not present in the chart
+     */
+    int findNumOfManagersBetween(Employee* head, int e1_id, int e2_id);
+
+    /**
+     * Count the employees of an organization chart.
+     *
+     * @param  head the head / root Employee of the organization chart
+     * @return      number of employees, 0 if head is nullptr
+     */
+    long long countEmployees(Employee* head);
+
+    /**
+     * Aggregate a value over every employee of an organization chart.
+     *
+     * <p>
+     * Every worker combines map(employee, level) of the employees it walks into its own
+     * partial result, starting from identity, and the partial results are combined at the end.
+     * Employees are walked in no particular order, so combine must be associative and commutative.
+     *
+     * @param  head      the head / root Employee of the organization chart
+     * @param  headLevel the level of the head employee of the organization
+     * @param  identity  the result for an empty chart, combine(identity, x) == x
+     * @param  map       callable (Employee*, int level) -> T, run concurrently by the workers
+     * @param  combine   callable (T, T) -> T
+     * @return           the combined value of all employees
+     */
+    template <typename T, typename Map, typename Combine>
+    T reduce(Employee* head, int headLevel, T identity, Map map, Combine combine);
+
+};
+
+/**
+ * Walk tasks until the traversal is finished or stopped.
+ *
+ * <p>
+ * visit(worker, employee, level) is called once per employee and returns true to stop
+ * the whole traversal.
+ */
+template <typename Visit>
+void ParallelOrgtree::walk(int worker, Visit &visit) {
+    vector<Task> local;
+    Task task;
+
+    while (!stopped.load(memory_order_relaxed)) {
+        if (!takeTask(worker, task)) {
+            // Every task is finished once none is queued or being walked
+            if (pendingTasks.load() == 0) {
+                return;
+            }
+            this_thread::yield();
+            continue;
+        }
+
+        local.push_back(task);
+        int walked = 0;
+        while (!local.empty()) {
+            Task current = local.back();
+            local.pop_back();
+
+            if (visit(worker, current.employee, current.level)) {
+                stopped.store(true);
+                return;
+            }
+
+            // Push the direct reports in reverse, so that the first one is walked first
+            const vector<Employee*> &directReports = current.employee->directReports;
+            for (size_t i = directReports.size(); i > 0; i--) {
+                if (directReports[i - 1] != nullptr) {
+                    Task directReport = { directReports[i - 1], current.level + 1 };
+                    local.push_back(directReport);
+                }
+            }
+
+            // Share the rest of a large subtree, and check if another worker stopped the search
+            if (++walked == grainSize) {
+                walked = 0;
+                if (stopped.load(memory_order_relaxed)) {
+                    return;
+                }
+                shareTasks(worker, local);
+            }
+        }
+        pendingTasks.fetch_sub(1);
+    }
+}
+
+/**
+ * Walk the chart under head on all workers, calling visit(worker, employee, level) for every employee.
+ */
+template <typename Visit>
+void ParallelOrgtree::traverse(Employee* head, int headLevel, Visit visit) {
+    if (head == nullptr) {
+        return;
+    }
+
+    lock_guard<mutex> traversal(traversalLock);
+    for (size_t w = 0; w < queues.size(); w++) {
+        queues[w].tasks.clear();
+    }
+    Task first = { head, headLevel };
+    queues[0].tasks.push_back(first);
+    pendingTasks.store(1);
+    stopped.store(false);
+
+    runJob([this, &visit](int worker) {
+        walk(worker, visit);
+    });
+}
+
+template <typename T, typename Map, typename Combine>
+T ParallelOrgtree::reduce(Employee* head, int headLevel, T identity, Map map, Combine combine) {
+    vector<Partial<T> > partials(numThreads);
+    for (int w = 0; w < numThreads; w++) {
+        partials[w].value = identity;
+    }
+
+    traverse(head, headLevel, [&](int worker, Employee* employee, int level) {
+        partials[worker].value = combine(partials[worker].value, map(employee, level));
+        return false;
+    });
+
+    T result = identity;
+    for (int w = 0; w < numThreads; w++) {
+        result = combine(result, partials[w].value);
+    }
+    return result;
+}
+
+#endif
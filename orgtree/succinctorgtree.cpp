@@ -0,0 +1,476 @@
+#include "succinctorgtree.h"
+
+#include <algorithm>    // sort, lower_bound, upper_bound, min_element
+#include <limits.h>     // INT_MAX
+
+const int SuccinctOrgtree::NO_INDEX;
+const int SuccinctOrgtree::BLOCK_BITS;
+const int SuccinctOrgtree::ID_FENCE_STEP;
+
+static const int WORDS_PER_BLOCK = SuccinctOrgtree::BLOCK_BITS / 64;
+
+// Excess change of the 8 bits of a byte, lowest bit first, and the lowest excess reached
+// going forward from before the byte or backward from its last bit
+struct ByteExcess {
+    int total;
+    int forwardMin;     // minimum of the excess after bits 0 .. t, for t = 0 .. 7
+    int backwardMin;    // minimum of the excess after bits 0 .. t minus the excess after all 8, for t = 0 .. 7
+};
+
+static vector<ByteExcess> buildByteExcessTable() {
+    vector<ByteExcess> table(256);
+    for (int b = 0; b < 256; b++) {
+        int prefix[8];
+        int e = 0;
+        for (int t = 0; t < 8; t++) {
+            e += ((b >> t) & 1) ? 1 : -1;
+            prefix[t] = e;
+        }
+        table[b].total = e;
+        table[b].forwardMin = *min_element(prefix, prefix + 8);
+        table[b].backwardMin = table[b].forwardMin - e;
+    }
+    return table;
+}
+
+// Built on first use, which is thread-safe for a local static
+static const ByteExcess* byteExcessTable() {
+    static const vector<ByteExcess> table = buildByteExcessTable();
+    return table.data();
+}
+
+/**
+ * Encode the organization chart under head.
+ *
+ * <p>
+ * A depth-first walk with an explicit stack writes the parentheses and the IDs in pre-order:
+ * every employee is pushed once to be entered and once to be left after all its reports.
+ * Then one pass over the bits fills in the rank and minimum excess of every block.
+ *
+ * @param  head the head / root Employee of the organization chart, may be nullptr
+ */
+SuccinctOrgtree::SuccinctOrgtree(Employee* head) : numBits(0), numLeaves(1) {
+
+    vector<pair<Employee*, bool> > toVisit;     // employee, and whether it is being left
+    if (head != nullptr) {
+        toVisit.push_back(make_pair(head, false));
+    }
+    while (!toVisit.empty()) {
+        Employee* employee = toVisit.back().first;
+        bool leaving = toVisit.back().second;
+        toVisit.pop_back();
+
+        if (numBits % 64 == 0) {
+            bits.push_back(0);
+        }
+        if (leaving) {
+            numBits++;
+            continue;
+        }
+        bits.back() |= (uint64_t)1 << (numBits % 64);
+        numBits++;
+        ids.push_back(employee->getEmployeeID());
+
+        // Leave the employee after all its direct reports, the first one is entered next
+        toVisit.push_back(make_pair(employee, true));
+        const vector<Employee*> &directReports = employee->getDirectReports();
+        for (int i = (int)directReports.size() - 1; i >= 0; i--) {
+            toVisit.push_back(make_pair(directReports[i], false));
+        }
+    }
+
+    // Whole blocks of words, so scans and ranks never read past the end
+    int numBlocks = (numBits + BLOCK_BITS - 1) / BLOCK_BITS;
+    bits.resize((size_t)numBlocks * WORDS_PER_BLOCK + 1, 0);
+    while (numLeaves < numBlocks) {
+        numLeaves *= 2;
+    }
+
+    blockRanks.resize(numBlocks + 1);
+    minTree.assign(2 * (size_t)numLeaves, INT_MAX);
+    int ones = 0;
+    int e = 0;
+    for (int block = 0; block < numBlocks; block++) {
+        blockRanks[block] = ones;
+        int blockMin = INT_MAX;
+        for (int j = block * BLOCK_BITS; j < numBits && j < (block + 1) * BLOCK_BITS; j++) {
+            e += bit(j) ? 1 : -1;
+            ones += bit(j);
+            blockMin = min(blockMin, e);
+        }
+        minTree[numLeaves + block] = blockMin;
+    }
+    blockRanks[numBlocks] = ones;
+    for (int node = numLeaves - 1; node > 0; node--) {
+        minTree[node] = min(minTree[2 * node], minTree[2 * node + 1]);
+    }
+
+    byID.resize(ids.size());
+    for (int i = 0; i < (int)ids.size(); i++) {
+        byID[i] = i;
+    }
+    const vector<int32_t> &employeeIDs = ids;
+    sort(byID.begin(), byID.end(), [&employeeIDs](int32_t a, int32_t b) {
+        return employeeIDs[a] < employeeIDs[b];
+    });
+    for (size_t i = 0; i < byID.size(); i += ID_FENCE_STEP) {
+        idFences.push_back(ids[byID[i]]);
+    }
+}
+
+int SuccinctOrgtree::size() const {
+    return (int)ids.size();
+}
+
+size_t SuccinctOrgtree::getTreeBytes() const {
+    return bits.size() * sizeof(uint64_t) + blockRanks.size() * sizeof(uint32_t) +
+           minTree.size() * sizeof(int32_t);
+}
+
+size_t SuccinctOrgtree::getIDBytes() const {
+    return (ids.size() + byID.size() + idFences.size()) * sizeof(int32_t);
+}
+
+bool SuccinctOrgtree::bit(int j) const {
+    return (bits[j >> 6] >> (j & 63)) & 1;
+}
+
+// Number of 1s in bits 0 .. end - 1
+int SuccinctOrgtree::rank1(int end) const {
+    int block = end / BLOCK_BITS;
+    int rank = blockRanks[block];
+    for (int w = block * WORDS_PER_BLOCK; w < end / 64; w++) {
+        rank += __builtin_popcountll(bits[w]);
+    }
+    if (end & 63) {
+        rank += __builtin_popcountll(bits[end >> 6] & (((uint64_t)1 << (end & 63)) - 1));
+    }
+    return rank;
+}
+
+// Position of the 1 with the given rank, counting from 0: a binary search over the block
+// ranks, then a popcount per word and a bit per remaining 1 in the word
+int SuccinctOrgtree::select1(int rank) const {
+    int numBlocks = (int)blockRanks.size() - 1;
+    int block = (int)(upper_bound(blockRanks.begin(), blockRanks.begin() + numBlocks, (uint32_t)rank) -
+                      blockRanks.begin()) - 1;
+    int remaining = rank - (int)blockRanks[block];
+    int w = block * WORDS_PER_BLOCK;
+    for (int count = __builtin_popcountll(bits[w]); remaining >= count; count = __builtin_popcountll(bits[w])) {
+        remaining -= count;
+        w++;
+    }
+    uint64_t word = bits[w];
+    for (int i = 0; i < remaining; i++) {
+        word &= word - 1;
+    }
+    return w * 64 + __builtin_ctzll(word);
+}
+
+// E(j), with E(-1) = 0
+int SuccinctOrgtree::excess(int j) const {
+    return 2 * rank1(j + 1) - (j + 1);
+}
+
+/**
+ * First j in from .. end - 1 with E(j) <= target, -1 if there is none.
+ * e is E(from - 1). Whole bytes whose minimum stays above target are skipped.
+ */
+int SuccinctOrgtree::scanForward(int from, int end, int e, int target) const {
+    const ByteExcess* table = byteExcessTable();
+    int j = from;
+    for (; j < end && (j & 7) != 0; j++) {
+        e += bit(j) ? 1 : -1;
+        if (e <= target) {
+            return j;
+        }
+    }
+    for (; j + 8 <= end; j += 8) {
+        const ByteExcess &byte = table[(bits[j >> 6] >> (j & 63)) & 0xFF];
+        if (e + byte.forwardMin <= target) {
+            break;
+        }
+        e += byte.total;
+    }
+    for (; j < end; j++) {
+        e += bit(j) ? 1 : -1;
+        if (e <= target) {
+            return j;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Last j in start .. from with E(j) <= target, -1 if there is none.
+ * e is E(from). Whole bytes whose minimum stays above target are skipped.
+ */
+int SuccinctOrgtree::scanBackward(int from, int start, int e, int target) const {
+    const ByteExcess* table = byteExcessTable();
+    int j = from;
+    for (; j >= start && ((j + 1) & 7) != 0; j--) {
+        if (e <= target) {
+            return j;
+        }
+        e -= bit(j) ? 1 : -1;
+    }
+    for (; j - 7 >= start; j -= 8) {
+        const ByteExcess &byte = table[(bits[(j - 7) >> 6] >> ((j - 7) & 63)) & 0xFF];
+        if (e + byte.backwardMin <= target) {
+            break;
+        }
+        e -= byte.total;
+    }
+    for (; j >= start; j--) {
+        if (e <= target) {
+            return j;
+        }
+        e -= bit(j) ? 1 : -1;
+    }
+    return -1;
+}
+
+// Minimum of E(j) for j in from .. end - 1, e is E(from - 1)
+int SuccinctOrgtree::scanMin(int from, int end, int e) const {
+    const ByteExcess* table = byteExcessTable();
+    int minimum = INT_MAX;
+    int j = from;
+    for (; j < end && (j & 7) != 0; j++) {
+        e += bit(j) ? 1 : -1;
+        minimum = min(minimum, e);
+    }
+    for (; j + 8 <= end; j += 8) {
+        const ByteExcess &byte = table[(bits[j >> 6] >> (j & 63)) & 0xFF];
+        minimum = min(minimum, e + byte.forwardMin);
+        e += byte.total;
+    }
+    for (; j < end; j++) {
+        e += bit(j) ? 1 : -1;
+        minimum = min(minimum, e);
+    }
+    return minimum;
+}
+
+/**
+ * First j >= from with E(j) <= target, numBits if there is none.
+ * The rest of from's block is scanned, then the tree of block minimums leads to the first
+ * later block that gets down to target, climbing to the first right sibling that does and
+ * descending to its leftmost such leaf.
+ */
+int SuccinctOrgtree::forwardSearch(int from, int target) const {
+    if (from >= numBits) {
+        return numBits;
+    }
+    int block = from / BLOCK_BITS;
+    int found = scanForward(from, min(numBits, (block + 1) * BLOCK_BITS), excess(from - 1), target);
+    if (found != -1) {
+        return found;
+    }
+
+    int node = numLeaves + block;
+    while (node > 1 && !((node & 1) == 0 && minTree[node + 1] <= target)) {
+        node /= 2;
+    }
+    if (node == 1) {
+        return numBits;
+    }
+    node++;
+    while (node < numLeaves) {
+        node = (minTree[2 * node] <= target) ? 2 * node : 2 * node + 1;
+    }
+    int start = (node - numLeaves) * BLOCK_BITS;
+    return scanForward(start, min(numBits, start + BLOCK_BITS), excess(start - 1), target);
+}
+
+/**
+ * Last j <= from with E(j) <= target, -1 if there is none.
+ * The mirror image of forwardSearch, climbing to the first left sibling that gets down to target.
+ */
+int SuccinctOrgtree::backwardSearch(int from, int target) const {
+    if (from < 0) {
+        return -1;
+    }
+    int block = from / BLOCK_BITS;
+    int found = scanBackward(from, block * BLOCK_BITS, excess(from), target);
+    if (found != -1) {
+        return found;
+    }
+
+    int node = numLeaves + block;
+    while (node > 1 && !((node & 1) == 1 && minTree[node - 1] <= target)) {
+        node /= 2;
+    }
+    if (node == 1) {
+        return -1;
+    }
+    node--;
+    while (node < numLeaves) {
+        node = (minTree[2 * node + 1] <= target) ? 2 * node + 1 : 2 * node;
+    }
+    int start = (node - numLeaves) * BLOCK_BITS;
+    int last = min(numBits, start + BLOCK_BITS) - 1;
+    return scanBackward(last, start, excess(last), target);
+}
+
+// Minimum of E(j) for j in first .. last: two partial blocks and the block minimums between them
+int SuccinctOrgtree::rangeMin(int first, int last) const {
+    int firstBlock = first / BLOCK_BITS;
+    int lastBlock = last / BLOCK_BITS;
+    if (firstBlock == lastBlock) {
+        return scanMin(first, last + 1, excess(first - 1));
+    }
+
+    int lastStart = lastBlock * BLOCK_BITS;
+    int minimum = min(scanMin(first, (firstBlock + 1) * BLOCK_BITS, excess(first - 1)),
+                      scanMin(lastStart, last + 1, excess(lastStart - 1)));
+    for (int lo = numLeaves + firstBlock + 1, hi = numLeaves + lastBlock; lo < hi; lo /= 2, hi /= 2) {
+        if (lo & 1) {
+            minimum = min(minimum, minTree[lo++]);
+        }
+        if (hi & 1) {
+            minimum = min(minimum, minTree[--hi]);
+        }
+    }
+    return minimum;
+}
+
+// Position where the subtree of the employee entered at p is left
+int SuccinctOrgtree::findClose(int p) const {
+    return forwardSearch(p + 1, excess(p) - 1);
+}
+
+// Position where the direct manager of the employee entered at p is entered, -1 for the head
+int SuccinctOrgtree::enclose(int p) const {
+    if (p == 0) {
+        return -1;
+    }
+    return backwardSearch(p - 1, excess(p) - 2) + 1;
+}
+
+/**
+ * Closest shared manager of the employees entered at p and q.
+ *
+ * <p>
+ * Unless one manages the other, the lowest excess between p and q is where a direct report
+ * of the shared manager is left, and the next position enters another of its direct reports.
+ */
+int SuccinctOrgtree::closestSharedManagerPosition(int p, int q) const {
+    if (p > q) {
+        swap(p, q);
+    }
+    if (q <= findClose(p)) {
+        return p;
+    }
+    int lowest = forwardSearch(p, rangeMin(p, q));
+    return enclose(lowest + 1);
+}
+
+// The last fence at most e_id starts the only run of ID_FENCE_STEP entries that can hold it
+int SuccinctOrgtree::indexOf(int e_id) const {
+    int fence = (int)(upper_bound(idFences.begin(), idFences.end(), e_id) - idFences.begin()) - 1;
+    if (fence < 0) {
+        return NO_INDEX;
+    }
+    vector<int32_t>::const_iterator first = byID.begin() + (size_t)fence * ID_FENCE_STEP;
+    vector<int32_t>::const_iterator last = byID.begin() + min(byID.size(), (size_t)(fence + 1) * ID_FENCE_STEP);
+
+    const vector<int32_t> &employeeIDs = ids;
+    vector<int32_t>::const_iterator found = lower_bound(first, last, e_id,
+        [&employeeIDs](int32_t index, int id) {
+            return employeeIDs[index] < id;
+        });
+    return (found != last && ids[*found] == e_id) ? *found : NO_INDEX;
+}
+
+int SuccinctOrgtree::positionOf(int e_id) const {
+    int index = indexOf(e_id);
+    return (index == NO_INDEX) ? -1 : select1(index);
+}
+
+int SuccinctOrgtree::getEmployeeID(int index) const {
+    return ids[index];
+}
+
+int SuccinctOrgtree::getManagerIndex(int index) const {
+    int manager = enclose(select1(index));
+    return (manager == -1) ? NO_INDEX : rank1(manager);
+}
+
+int SuccinctOrgtree::getLevel(int index) const {
+    return excess(select1(index)) - 1;
+}
+
+bool SuccinctOrgtree::findDirectReports(int e_id, vector<int> &directReports) const {
+    int p = positionOf(e_id);
+    if (p == -1) {
+        return false;
+    }
+    // The first direct report is entered right after p, each next one right after the previous one is left
+    for (int child = p + 1; child < numBits && bit(child); child = findClose(child) + 1) {
+        directReports.push_back(ids[rank1(child)]);
+    }
+    return true;
+}
+
+bool SuccinctOrgtree::isEmployeePresentInOrg(int e_id) const {
+    return indexOf(e_id) != NO_INDEX;
+}
+
+bool SuccinctOrgtree::findManagersOfEmployee(int e_id, vector<int> &managers) const {
+    int p = positionOf(e_id);
+    if (p == -1) {
+        return false;
+    }
+    for (int manager = enclose(p); manager != -1; manager = enclose(manager)) {
+        managers.push_back(ids[rank1(manager)]);
+    }
+    return true;
+}
+
+int SuccinctOrgtree::findEmployeeLevel(int e_id, int headLevel) const {
+    int p = positionOf(e_id);
+    return (p == -1) ? Employee::NOT_FOUND : headLevel + excess(p) - 1;
+}
+
+int SuccinctOrgtree::findClosestSharedManager(int e1_id, int e2_id) const {
+    int p1 = positionOf(e1_id);
+    int p2 = positionOf(e2_id);
+
+    if (p1 == -1 && p2 == -1) {
+        return Employee::NOT_FOUND;
+    }
+    if (p2 == -1) {
+        return e1_id;
+    }
+    if (p1 == -1) {
+        return e2_id;
+    }
+    return ids[rank1(closestSharedManagerPosition(p1, p2))];
+}
+
+int SuccinctOrgtree::findNumOfManagersBetween(int e1_id, int e2_id) const {
+    int p1 = positionOf(e1_id);
+    int p2 = positionOf(e2_id);
+
+    if (p1 == -1 || p2 == -1) {
+        return Employee::NOT_FOUND;
+    }
+
+    int sharedManager = closestSharedManagerPosition(p1, p2);
+    return (excess(p1) - excess(sharedManager)) + (excess(p2) - excess(sharedManager)) - 1;
+}
+
+bool SuccinctOrgtree::isManagerOf(int m_id, int e_id) const {
+    int pm = positionOf(m_id);
+    int pe = positionOf(e_id);
+
+    if (pm == -1 || pe == -1) {
+        return false;
+    }
+    return pm < pe && pe < findClose(pm);
+}
+
+int SuccinctOrgtree::findNumOfEmployeesUnder(int e_id) const {
+    int p = positionOf(e_id);
+    return (p == -1) ? Employee::NOT_FOUND : (findClose(p) - p + 1) / 2 - 1;
+}
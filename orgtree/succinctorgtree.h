@@ -0,0 +1,115 @@
+#ifndef SUCCINCTORGTREE_H
+#define SUCCINCTORGTREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "orgtree.h"
+
+using namespace std;
+
+// A read-only organization chart in about 2.5 bits per employee, plus the employee IDs.
+//
+// The shape of the chart is stored as balanced parentheses: a depth-first walk writes a 1 when
+// it enters an employee and a 0 when it leaves, so a chart of N employees takes 2N bits.
+// Employee i in pre-order is the i-th 1, and with the excess E(j) = (number of 1s) -
+// (number of 0s) in bits 0 .. j, every query is a search for a given excess:
+//   level of the employee entered at p     E(p) - 1
+//   end of its subtree                     first j > p with E(j) = E(p) - 1
+//   its direct manager                     one past the last j < p with E(j) = E(p) - 2
+//   closest shared manager of p < q        the manager of the employee entered right after
+//                                          the minimum excess in p .. q
+// The bits are split in blocks of BLOCK_BITS. Every block keeps the number of 1s before it
+// (for rank and select) and the minimum excess inside it, and a binary tree over the block
+// minimums skips whole ranges of blocks, so searches take O(log N) plus two block scans.
+//
+// Employee IDs are kept in pre-order, the dense numbering of the chart, and a list of
+// pre-order indices sorted by ID maps IDs back to it, for 8 bytes per employee in total.
+// Every 64th ID of that list is copied into a small fence array, so a lookup binary searches
+// the fences and then only 64 entries of the list.
+// Supports up to 2^30 employees.
+class SuccinctOrgtree {
+
+public:
+    // Index of a missing employee, and the manager index of the head
+    static const int NO_INDEX = -1;
+
+    // Bits per block of the rank and minimum excess directories
+    static const int BLOCK_BITS = 512;
+
+private:
+    int numBits;                    // 2 * size()
+    vector<uint64_t> bits;          // the parentheses, bit j is bit j % 64 of word j / 64
+    vector<uint32_t> blockRanks;    // number of 1s before each block, and in all bits at the end
+    vector<int32_t> minTree;        // minimum excess of every block at numLeaves + block, of every range above
+    int numLeaves;                  // power of two, at least the number of blocks
+    vector<int32_t> ids;            // employee IDs in pre-order
+    vector<int32_t> byID;           // pre-order indices sorted by employee ID
+    vector<int32_t> idFences;       // ID of every ID_FENCE_STEP-th entry of byID, narrows the search in byID
+
+    static const int ID_FENCE_STEP = 64;
+
+    bool bit(int j) const;
+    int rank1(int end) const;
+    int select1(int rank) const;
+    int excess(int j) const;
+
+    int scanForward(int from, int end, int e, int target) const;
+    int scanBackward(int from, int start, int e, int target) const;
+    int scanMin(int from, int end, int e) const;
+    int forwardSearch(int from, int target) const;
+    int backwardSearch(int from, int target) const;
+    int rangeMin(int first, int last) const;
+
+    // Navigation on the position where an employee is entered
+    int findClose(int p) const;
+    int enclose(int p) const;
+    int closestSharedManagerPosition(int p, int q) const;
+    int positionOf(int e_id) const;
+
+public:
+    /**
+     * Encode the organization chart under head.
+     * The Employee tree is only read, and it can be deleted once the succinct tree is built.
+     *
+     * @param  head the head / root Employee of the organization chart, may be nullptr
+     */
+    explicit SuccinctOrgtree(Employee* head);
+
+    // Number of employees in the chart
+    int size() const;
+
+    // Bytes used by the parentheses with their directories, and by the IDs with their lookup list
+    size_t getTreeBytes() const;
+    size_t getIDBytes() const;
+
+    // Index of employee e_id in pre-order, NO_INDEX if e_id is not present. O(log N)
+    int indexOf(int e_id) const;
+
+    // Accessors by pre-order index, 0 <= index < size(). O(log N)
+    int getEmployeeID(int index) const;
+    int getManagerIndex(int index) const;
+    int getLevel(int index) const;
+
+    /**
+     * List the direct reports of an employee, in the order of the original chart.
+     *
+     * @param  e_id          the employee id being searched
+     * @param  directReports ids of the direct reports of e
+     * @return               is employee found
+     */
+    bool findDirectReports(int e_id, vector<int> &directReports) const;
+
+    // Same results as the FlatOrgtree queries of the encoded chart
+    bool isEmployeePresentInOrg(int e_id) const;
+    bool findManagersOfEmployee(int e_id, vector<int> &managers) const;
+    int findEmployeeLevel(int e_id, int headLevel) const;
+    int findClosestSharedManager(int e1_id, int e2_id) const;
+    int findNumOfManagersBetween(int e1_id, int e2_id) const;
+    bool isManagerOf(int m_id, int e_id) const;
+    int findNumOfEmployeesUnder(int e_id) const;
+
+};
+
+#endif
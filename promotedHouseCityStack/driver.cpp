@@ -1,7 +1,12 @@
 #include <stdlib.h>
 #include <iostream>
 
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 #include "promotedHouseCityStack.h"
+#include "shardedPromotedHouseCityStack.h"
 
 #define CITY_SD "SD"
 #define CITY_LA "LA"
@@ -73,6 +78,221 @@ void testHighestLowestPeek(string highestPricedHouseCity,
     }
 }
 
+void testNonThrowingAccessors() {
+
+    PromotedHouseCityStack stack;
+    PromotedCity popped;
+
+    cout << endl << "Polling an empty stack" << endl;
+    if (stack.tryPeek() == nullptr && !stack.tryPop(popped) && stack.isEmpty()) {
+        cout << "Empty stack tryPeek / tryPop report empty" << endl;
+    } else {
+        cout << "FAILED: Empty stack tryPeek / tryPop do NOT report empty!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    cout << endl << "Emplacing " << CITY_SF << " at 99,000 and " << CITY_SB << " at 45,000" << endl;
+    stack.emplace(CITY_SF, 99000);
+    string city = CITY_SB;
+    stack.emplace(std::move(city), 45000);
+
+    const PromotedCity *top = stack.tryPeek();
+    if (top != nullptr && equalsIgnoreCase(top->getCity(), CITY_SB) && top->getPromotedPrice() == 45000 &&
+        &stack.peek() == top) {
+        cout << "Stack tryPeek matches peek" << endl;
+    } else {
+        cout << "FAILED: Stack tryPeek does NOT match peek!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (&stack.getHighestPricedPromotedCity().getCity() == &stack.getHighestPricedPromotedCity().getCity() &&
+        equalsIgnoreCase(stack.getHighestPricedPromotedCity().getCity(), CITY_SF) &&
+        equalsIgnoreCase(stack.getLowestPricedPromotedCity().getCity(), CITY_SB)) {
+        cout << "Stack highest / lowest references match" << endl;
+    } else {
+        cout << "FAILED: Stack highest / lowest references do NOT match!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (stack.tryPop(popped) && equalsIgnoreCase(popped.getCity(), CITY_SB) && popped.getPromotedPrice() == 45000 &&
+        stack.tryPop(popped) && equalsIgnoreCase(popped.getCity(), CITY_SF) && popped.getPromotedPrice() == 99000 &&
+        !stack.tryPop(popped) && equalsIgnoreCase(popped.getCity(), CITY_SF)) {
+        cout << "Stack tryPop matches" << endl;
+    } else {
+        cout << "FAILED: Stack tryPop does NOT match!" << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+void testSegmentedStorage() {
+
+    // Enough cities to span several storage chunks, with the highest and lowest prices in the middle
+    const int NUM_CITIES = 1000;
+    PromotedHouseCityStack stack;
+
+    cout << endl << "Pushing " << NUM_CITIES << " cities across storage chunks" << endl;
+    stack.push(CITY_SD, 0);
+    const PromotedCity *bottomCity = &stack.peek();
+    for (int i = 1; i < NUM_CITIES; i++) {
+        stack.push(CITY_SD, (i * 7919) % NUM_CITIES);
+    }
+
+    if (&stack.getLowestPricedPromotedCity() == bottomCity) {
+        cout << "Segmented stack keeps its cities in place while growing" << endl;
+    } else {
+        cout << "FAILED: Segmented stack moved its bottom city!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    PromotedHouseCityStack copy = stack;
+
+    // Pop everything and check the running extremes against a scan of the prices still on the stack
+    for (int remaining = NUM_CITIES; remaining > 0; remaining--) {
+        int highest = -1, lowest = NUM_CITIES;
+        for (int i = 0; i < remaining; i++) {
+            int price = (i * 7919) % NUM_CITIES;
+            highest = (price > highest) ? price : highest;
+            lowest = (price < lowest) ? price : lowest;
+        }
+        if (stack.size() != (size_t)remaining ||
+            stack.getHighestPricedPromotedCity().getPromotedPrice() != highest ||
+            stack.getLowestPricedPromotedCity().getPromotedPrice() != lowest) {
+            cout << "FAILED: Segmented stack extremes do NOT match with " << remaining << " cities!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        stack.pop();
+    }
+    cout << "Segmented stack extremes match while popping every city" << endl;
+
+    // Pushing again reuses the storage, so the bottom city lands in the same slot
+    stack.push(CITY_LA, 1);
+    if (&stack.peek() == bottomCity) {
+        cout << "Segmented stack reuses its storage" << endl;
+    } else {
+        cout << "FAILED: Segmented stack does NOT reuse its storage!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (copy.size() == (size_t)NUM_CITIES && copy.peek().getPromotedPrice() == ((NUM_CITIES - 1) * 7919) % NUM_CITIES &&
+        copy.getHighestPricedPromotedCity().getPromotedPrice() == NUM_CITIES - 1 &&
+        copy.getLowestPricedPromotedCity().getPromotedPrice() == 0) {
+        cout << "Copied segmented stack matches" << endl;
+    } else {
+        cout << "FAILED: Copied segmented stack does NOT match!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    cout << endl << "Filling a bounded stack of capacity 2" << endl;
+    PromotedHouseCityStack bounded(2);
+    bounded.push(CITY_IR, 35000);
+    bounded.push(CITY_SJ, 91000);
+    try {
+        bounded.push(CITY_SF, 99000);
+        cout << "FAILED: Full bounded stack did NOT throw!" << endl;
+        exit(EXIT_FAILURE);
+    } catch (const logic_error &e) {
+        cout << "Full bounded stack throws logic_error" << endl;
+    }
+    if (bounded.isFull() && bounded.getHighestPricedPromotedCity().getPromotedPrice() == 91000 &&
+        bounded.pop().getPromotedPrice() == 91000 && !bounded.isFull()) {
+        cout << "Bounded stack has room again after popping" << endl;
+    } else {
+        cout << "FAILED: Bounded stack does NOT match!" << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+void testShardedHighestLowest(int highestPrice,
+                              int highestShard,
+                              int lowestPrice,
+                              int lowestShard,
+                              ShardedPromotedHouseCityStack &stacks) {
+
+    if (stacks.getHighestPromotedPrice() == highestPrice &&
+        stacks.getHighestPricedShard() == highestShard) {
+        cout << "Sharded highest price and shard match" << endl;
+    } else {
+        cout << "FAILED: Sharded highest price or shard does NOT match!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (stacks.getLowestPromotedPrice() == lowestPrice &&
+        stacks.getLowestPricedShard() == lowestShard) {
+        cout << "Sharded lowest price and shard match" << endl;
+    } else {
+        cout << "FAILED: Sharded lowest price or shard does NOT match!" << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+void testShardedStack() {
+
+    ShardedPromotedHouseCityStack stacks(3);
+
+    if (stacks.getHighestPricedShard() == ShardedPromotedHouseCityStack::NO_SHARD &&
+        stacks.getLowestPricedShard() == ShardedPromotedHouseCityStack::NO_SHARD) {
+        cout << "Empty sharded stack has no highest or lowest shard" << endl;
+    } else {
+        cout << "FAILED: Empty sharded stack reports a highest or lowest shard!" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    try {
+        stacks.getHighestPromotedPrice();
+        cout << "FAILED: Empty sharded stack did NOT throw!" << endl;
+        exit(EXIT_FAILURE);
+    } catch (const logic_error &e) {
+        cout << "Empty sharded stack throws logic_error" << endl;
+    }
+
+    cout << endl << "Pushing " << CITY_SD << " at 38,000 on shard 0" << endl;
+    stacks.push(0, CITY_SD, 38000);
+    testShardedHighestLowest(38000, 0, 38000, 0, stacks);
+
+    cout << endl << "Pushing " << CITY_SJ << " at 91,000 on shard 2" << endl;
+    stacks.push(2, CITY_SJ, 91000);
+    testShardedHighestLowest(91000, 2, 38000, 0, stacks);
+
+    cout << endl << "Pushing " << CITY_SB << " at 21,000 on shard 1" << endl;
+    stacks.push(1, CITY_SB, 21000);
+    testShardedHighestLowest(91000, 2, 21000, 1, stacks);
+
+    cout << endl << "Popping from shard 2" << endl;
+    PromotedCity popped = stacks.pop(2);
+    if (equalsIgnoreCase(popped.getCity(), CITY_SJ) && popped.getPromotedPrice() == 91000) {
+        cout << "Popped sharded city matches" << endl;
+    } else {
+        cout << "FAILED: Popped sharded city does NOT match!" << endl;
+        exit(EXIT_FAILURE);
+    }
+    testShardedHighestLowest(38000, 0, 21000, 1, stacks);
+
+    // One writer thread per shard, each pushing and popping its own stack concurrently
+    const int NUM_SHARDS = 8;
+    const int PUSHES_PER_SHARD = 20000;
+    ShardedPromotedHouseCityStack concurrentStacks(NUM_SHARDS);
+    vector<thread> writers;
+
+    cout << endl << "Pushing and popping concurrently on " << NUM_SHARDS << " shards" << endl;
+    for (int shard = 0; shard < NUM_SHARDS; shard++) {
+        writers.push_back(thread([&concurrentStacks, shard, PUSHES_PER_SHARD]() {
+            for (int i = 0; i < PUSHES_PER_SHARD; i++) {
+                concurrentStacks.push(shard, CITY_LA, shard * PUSHES_PER_SHARD + i);
+                if (i % 3 == 0) {
+                    concurrentStacks.pop(shard);
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < writers.size(); i++) {
+        writers[i].join();
+    }
+
+    // The last writer pushes the highest prices, and shard 0 keeps the lowest price (1) it pushed
+    testShardedHighestLowest(NUM_SHARDS * PUSHES_PER_SHARD - 1, NUM_SHARDS - 1,
+                             1, 0, concurrentStacks);
+}
+
 int main(int argc, char **argv) {
 
     PromotedHouseCityStack stack;
@@ -116,6 +336,12 @@ int main(int argc, char **argv) {
                           CITY_IR, 35000,
                           CITY_LA, 64000, stack);
 
+    testNonThrowingAccessors();
+
+    testSegmentedStorage();
+
+    testShardedStack();
+
     cout << endl << "SUCCESS! All tests passed!" << endl;
 
     exit(EXIT_SUCCESS);
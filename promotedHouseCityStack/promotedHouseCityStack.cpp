@@ -1,6 +1,51 @@
 #include "promotedHouseCityStack.h"
 #include <stdexcept> // header for logic_error exception class
 
+/**
+   * @brief create an unbounded stack
+   */
+PromotedHouseCityStack::PromotedHouseCityStack() : entries() {
+}
+
+/**
+   * @brief create a bounded stack with all of its storage allocated up front
+   * @param capacity
+   * @throws invalid_argument If capacity is 0
+   */
+PromotedHouseCityStack::PromotedHouseCityStack(size_t capacity) : entries(capacity) {
+    if (capacity == 0) {
+        throw invalid_argument("Promoted house city stack capacity must be positive");
+    }
+}
+
+/**
+   * @brief copy a stack by pushing its cities again, from the bottom to the top,
+            which rebuilds the same price ranges on top of our own storage.
+            A copy of a bounded stack is bounded to the same capacity.
+   */
+PromotedHouseCityStack::PromotedHouseCityStack(const PromotedHouseCityStack &other)
+    : entries(other.entries.getCapacity()) {
+    other.entries.forEach([this](const PromotedCityEntry &entry) {
+        emplace(entry.promotedCity.getCity(), entry.promotedCity.getPromotedPrice());
+    });
+}
+
+/**
+   * @brief replace the contents of this stack with a copy of the other stack, keeping this stack's storage mode
+   * @throws logic_error If this stack is bounded and the other stack does not fit in it
+   */
+PromotedHouseCityStack &PromotedHouseCityStack::operator=(const PromotedHouseCityStack &other) {
+    if (this != &other) {
+        while (!entries.empty()) {
+            entries.pop_back();
+        }
+        other.entries.forEach([this](const PromotedCityEntry &entry) {
+            emplace(entry.promotedCity.getCity(), entry.promotedCity.getPromotedPrice());
+        });
+    }
+    return *this;
+}
+
 /**
    * @brief push operation, pushing the latest promoted city onto the stack
             Both time and auxiliary space complexity need to be O(1)
@@ -9,29 +54,44 @@
    */
 void PromotedHouseCityStack::push(string city, int price) {
 
-    // Create a PromotedCity object with the provided city and price
-    PromotedCity promotedCity(city, price);
-
-    // Add the PromotedCity object to the end of the promotedCities vector
-    promotedCities.push_back(promotedCity);
-
-    // If the priceRanges vector is empty, create a new PriceRange and add it to the vector
-    if (priceRanges.empty()) {
-        PriceRange range;
-        range.highest = promotedCity;
-        range.lowest = promotedCity;
-        priceRanges.push_back(range);
-    } else {
-        // Get the current highest and lowest prices from the back of the vector PriceRange
-        PriceRange currentRange = priceRanges.back();
-
-        // Create a new PriceRange with the updated highest and lowest prices
-        PriceRange newRange;
-        newRange.highest = (promotedCity.getPromotedPrice() > currentRange.highest.getPromotedPrice()) ? promotedCity : currentRange.highest;
-        newRange.lowest = (promotedCity.getPromotedPrice() < currentRange.lowest.getPromotedPrice()) ? promotedCity : currentRange.lowest;
-
-        // Push/Add the new PriceRange into the priceRanges vector from the back
-        priceRanges.push_back(newRange);
+    // The city parameter is already our own copy, so hand it over to the stack instead of copying it again
+    emplace(std::move(city), price);
+}
+
+/**
+   * @brief emplace operation, constructing the latest promoted city in place on top of the stack
+            Both time and auxiliary space complexity need to be O(1)
+   * @param city
+   * @param price
+   */
+void PromotedHouseCityStack::emplace(const string &city, int price) {
+
+    // Copy the city once, then move that copy straight into its slot on top of the stack
+    emplace(string(city), price);
+}
+
+void PromotedHouseCityStack::emplace(string &&city, int price) {
+
+    // A bounded stack has no storage left once it is full
+    if (entries.isFull()) {
+        throw logic_error("Promoted house city stack is full");
+    }
+
+    // Get the current highest and lowest priced cities before the new city goes on top
+    const PriceRange *currentRange = entries.empty() ? nullptr : &entries.back().range;
+
+    // Construct the new entry directly on top of the stack, starting as its own highest and lowest city
+    entries.emplace_back(std::move(city), price);
+    PromotedCityEntry &entry = entries.back();
+
+    // If the stack was not empty, carry over whichever of the previous highest and lowest cities still win
+    if (currentRange != nullptr) {
+        if (price <= currentRange->highest->getPromotedPrice()) {
+            entry.range.highest = currentRange->highest;
+        }
+        if (price >= currentRange->lowest->getPromotedPrice()) {
+            entry.range.lowest = currentRange->lowest;
+        }
     }
 }
 
@@ -41,48 +101,85 @@ void PromotedHouseCityStack::push(string city, int price) {
             Both time and auxiliary space complexity need to be O(1)
    * @param
    * @return The topmost PromotedCity object that was removed from the stack
-   * @throws logic_error If either the promotedCities vector or the priceRanges vector is empty
+   * @throws logic_error If the stack is empty
    */
 PromotedCity PromotedHouseCityStack::pop() {
 
-    // If either the promotedCities vector or the priceRanges vector is empty, indicating that there are no promoted cities
+    // If the stack is empty, indicating that there are no promoted cities
     // in the stack, a logic_error is thrown, and as a result, there is no PromotedCity object to remove and return.
-    if (promotedCities.empty() || priceRanges.empty()) {
+    if (entries.empty()) {
         throw logic_error("Promoted house city stack is empty");
     }
 
-    // Get the last promoted city from the back of promotedCities vector
-    PromotedCity promotedCity = promotedCities.back();
+    // Move the last promoted city out of the top of the stack
+    PromotedCity promotedCity = std::move(entries.back().promotedCity);
 
-    // Remove the last PromotedCity object from the vector
-    promotedCities.pop_back();
-
-    // Remove the corresponding PriceRange from the priceRanges vector
-    priceRanges.pop_back();
+    // Remove the top entry, together with its PriceRange
+    entries.pop_back();
 
     // Return the removed PromotedCity object
     return promotedCity;
 
 }
 
+/**
+   * @brief tryPop operation, popping the latest promoted city off the stack without throwing
+            Both time and auxiliary space complexity need to be O(1)
+   * @param promotedCity receives the popped PromotedCity, untouched if the stack is empty
+   * @return false If the stack is empty
+   */
+bool PromotedHouseCityStack::tryPop(PromotedCity &promotedCity) {
+
+    // An empty stack is an expected outcome here, so report it instead of throwing
+    if (entries.empty()) {
+        return false;
+    }
+
+    // Move the last promoted city into the caller's object, then drop it and its PriceRange
+    promotedCity = std::move(entries.back().promotedCity);
+    entries.pop_back();
+
+    return true;
+
+}
+
 /**
    * @brief peek operation, peeking the latest promoted city at the top
             of the stack (without popping)
             Both time and auxiliary space complexity need to be O(1)
    * @param
    * @return The topmost PromotedCity object
-   * @throws logic_error If either the promotedCities vector or the priceRanges vector is empty
+   * @throws logic_error If the stack is empty
    */
-PromotedCity PromotedHouseCityStack::peek() {
+const PromotedCity &PromotedHouseCityStack::peek() const {
 
-    // If either the promotedCities vector or the priceRanges vector is empty, indicating that there are no promoted cities
+    // If the stack is empty, indicating that there are no promoted cities
     // in the stack, a logic_error is thrown, and as a result, there is no PromotedCity object to return.
-    if (promotedCities.empty() || priceRanges.empty()) {
+    if (entries.empty()) {
         throw logic_error("Promoted house city stack is empty");
     }
 
-    // Return the last PromotedCity object in the vector without removing it
-    return promotedCities.back();
+    // Return the topmost PromotedCity object without removing it
+    return entries.back().promotedCity;
+
+}
+
+/**
+   * @brief tryPeek operation, peeking the latest promoted city at the top
+            of the stack without throwing
+            Both time and auxiliary space complexity need to be O(1)
+   * @param
+   * @return Pointer to the topmost PromotedCity object, nullptr if the stack is empty
+   */
+const PromotedCity *PromotedHouseCityStack::tryPeek() const {
+
+    // An empty stack is an expected outcome here, so report it instead of throwing
+    if (entries.empty()) {
+        return nullptr;
+    }
+
+    // Point at the topmost PromotedCity object without removing it
+    return &entries.back().promotedCity;
 
 }
 
@@ -92,18 +189,18 @@ PromotedCity PromotedHouseCityStack::peek() {
             Both time and auxiliary space complexity need to be O(1)
    * @param
    * @return The PromotedCity object with the highest price
-   * @throws logic_error If either the promotedCities vector or the priceRanges vector is empty
+   * @throws logic_error If the stack is empty
    */
-PromotedCity PromotedHouseCityStack::getHighestPricedPromotedCity() {
+const PromotedCity &PromotedHouseCityStack::getHighestPricedPromotedCity() const {
 
-    // If either the promotedCities vector or the priceRanges vector is empty, indicating that there are no promoted cities
+    // If the stack is empty, indicating that there are no promoted cities
     // in the stack, a logic_error is thrown, and as a result, there is no PromotedCity object with the highest price to return.
-    if (promotedCities.empty() || priceRanges.empty()) {
+    if (entries.empty()) {
         throw logic_error("Promoted house city stack is empty");
     }
 
-    // Return the PromotedCity object with the highest price from the last PriceRange in the vector
-    return priceRanges.back().highest;
+    // Return the PromotedCity object with the highest price from the PriceRange at the top of the stack
+    return *entries.back().range.highest;
 
 }
 
@@ -113,17 +210,53 @@ PromotedCity PromotedHouseCityStack::getHighestPricedPromotedCity() {
             Both time and auxiliary space complexity need to be O(1)
    * @param
    * @return The PromotedCity object with the lowest price
-   * @throws logic_error If either the promotedCities vector or the priceRanges vector is empty
+   * @throws logic_error If the stack is empty
    */
-PromotedCity PromotedHouseCityStack::getLowestPricedPromotedCity() {
+const PromotedCity &PromotedHouseCityStack::getLowestPricedPromotedCity() const {
 
-    // If either the promotedCities vector or the priceRanges vector is empty, indicating that there are no promoted cities
+    // If the stack is empty, indicating that there are no promoted cities
     // in the stack, a logic_error is thrown, and as a result, there is no PromotedCity object with the lowest price to return.
-    if (promotedCities.empty() || priceRanges.empty()) {
+    if (entries.empty()) {
         throw logic_error("Promoted house city stack is empty");
     }
 
-    // Return the PromotedCity object with the lowest price from the last PriceRange in the vector
-    return priceRanges.back().lowest;
+    // Return the PromotedCity object with the lowest price from the PriceRange at the top of the stack
+    return *entries.back().range.lowest;
+
+}
+
+/**
+   * @brief isEmpty, checking whether there is any promoted city on the stack
+            Both time and auxiliary space complexity need to be O(1)
+   * @param
+   * @return true if the stack is empty
+   */
+bool PromotedHouseCityStack::isEmpty() const {
+
+    return entries.empty();
+
+}
+
+/**
+   * @brief isFull, checking whether a bounded stack has reached its capacity
+            Both time and auxiliary space complexity need to be O(1)
+   * @param
+   * @return true if no more cities can be pushed, always false for an unbounded stack
+   */
+bool PromotedHouseCityStack::isFull() const {
+
+    return entries.isFull();
+
+}
+
+/**
+   * @brief size, the number of promoted cities on the stack
+            Both time and auxiliary space complexity need to be O(1)
+   * @param
+   * @return size_t
+   */
+size_t PromotedHouseCityStack::size() const {
+
+    return entries.size();
 
 }
@@ -4,8 +4,11 @@
 #include <ctype.h>  // character manipualtion, e.g. tolower()
 #include <stdio.h>
 #include <string>
+#include <utility>  // std::move
 #include <vector>
 
+#include "segmentedStack.h"
+
 using namespace std;
 
 class PromotedCity {
@@ -20,16 +23,19 @@ public:
         this -> promotedPrice = -1;
     }
 
-    PromotedCity(string c, int p) {
-        this -> city = c;
-        this -> promotedPrice = p;
+    PromotedCity(const string &c, int p) : city(c), promotedPrice(p) {
+    }
+
+    // Takes over the city string instead of copying it
+    PromotedCity(string &&c, int p) : city(std::move(c)), promotedPrice(p) {
     }
 
-    inline string getCity() {
+    // Returns a reference to the stored city, valid as long as this PromotedCity is
+    inline const string &getCity() const {
         return city;
     }
 
-    inline int getPromotedPrice() {
+    inline int getPromotedPrice() const {
         return promotedPrice;
     }
 };
@@ -37,76 +43,165 @@ public:
 /**
  * @brief Structure to hold the highest and lowest promoted cities together.
  *
- * The PriceRange structure represents a range of prices for promoted cities. It consists of two PromotedCity objects:
+ * The PriceRange structure represents a range of prices for promoted cities. It consists of two pointers
+ * into the stack storage:
  *   - 'highest': The PromotedCity object with the highest price in the range.
  *   - 'lowest': The PromotedCity object with the lowest price in the range.
  *
  * By using this structure, we can store and track the highest and lowest promoted cities within a specific price range.
  * This allows for efficient retrieval of the highest and lowest priced cities from the overall collection of promoted cities.
+ * Pointing at the stored cities instead of copying them means a push never copies the city string again; the
+ * segmented storage never moves an element, so the pointers stay valid while the city is on the stack.
  */
 
 struct PriceRange {
-    PromotedCity highest; // The PromotedCity object with the highest price in the range
-    PromotedCity lowest; // The PromotedCity object with the lowest price in the range
+    const PromotedCity *highest; // The PromotedCity object with the highest price in the range
+    const PromotedCity *lowest; // The PromotedCity object with the lowest price in the range
+};
+
+/**
+ * @brief A promoted city on the stack, together with the price range of the stack up to and including it.
+ */
+struct PromotedCityEntry {
+    PromotedCity promotedCity;
+    PriceRange range;
+
+    PromotedCityEntry(string &&city, int price) : promotedCity(std::move(city), price) {
+        range.highest = &promotedCity;
+        range.lowest = &promotedCity;
+    }
 };
 
 class PromotedHouseCityStack {
 
 private:
-    vector<PromotedCity> promotedCities;  // To store the promoted cities object containing both city and price
-    vector<PriceRange> priceRanges;       // To store and track the highest and lowest priced cities over time
+    // To store the promoted cities and track the highest and lowest priced cities over time.
+    // Chunks are never reallocated, so no push or pop ever copies the history of the stack.
+    SegmentedStack<PromotedCityEntry> entries;
 
 public:
+    /**
+     * @brief create an unbounded stack, which takes storage chunks from a pool as it grows
+     *        and recycles them as it shrinks
+     */
+    PromotedHouseCityStack();
+
+    /**
+     * @brief create a bounded stack, with storage for all capacity cities allocated up front
+     * @param capacity the maximum number of promoted cities on the stack
+     * @throws invalid_argument if capacity is 0
+     */
+    explicit PromotedHouseCityStack(size_t capacity);
+
+    // Copies replay the pushes of the other stack, from its bottom to its top.
+    // Assigning to a bounded stack throws logic_error if the other stack does not fit.
+    PromotedHouseCityStack(const PromotedHouseCityStack &other);
+    PromotedHouseCityStack &operator=(const PromotedHouseCityStack &other);
+
     /**
      * @brief push operation, pushing the latest promoted city onto the stack
               Both time and auxiliary space complexity need to be O(1)
      * @param city
      * @param price
+     *         should throw a logic_error exception with an error message
+     *         “Promoted city stack is full” if a bounded PromotedHouseCityStack is full
      */
     void push(string city, int price);
 
+    /**
+     * @brief emplace operation, constructing the latest promoted city in place on top of the stack
+              Both time and auxiliary space complexity need to be O(1)
+     * @param city  copied (or moved, for an rvalue) straight into the stack
+     * @param price
+     *         should throw a logic_error exception with an error message
+     *         “Promoted city stack is full” if a bounded PromotedHouseCityStack is full
+     */
+    void emplace(const string &city, int price);
+    void emplace(string &&city, int price);
+
     /**
      * @brief pop operation, popping the latest promoted city off the stack
               Both time and auxiliary space complexity need to be O(1)
      * @param
-     * @return PromotedCity
+     * @return PromotedCity, moved out of the stack
      *         should throw a logic_error exception with an error message
      *         “Promoted city stack is empty” if the PromotedHouseCityStack is empty
      */
     PromotedCity pop();
 
+    /**
+     * @brief tryPop operation, popping the latest promoted city off the stack without throwing
+              Both time and auxiliary space complexity need to be O(1)
+     * @param promotedCity receives the popped PromotedCity, untouched if the stack is empty
+     * @return false if the PromotedHouseCityStack is empty
+     */
+    bool tryPop(PromotedCity &promotedCity);
+
     /**
      * @brief peek operation, peeking the latest promoted city at the top of the stack (without popping)
               Both time and auxiliary space complexity need to be O(1)
      * @param
-     * @return PromotedCity
+     * @return PromotedCity, a reference that stays valid until the next push or pop
      *         should throw a logic_error exception with an error message
      *         “Promoted city stack is empty” if the PromotedHouseCityStack is empty
      */
-    PromotedCity peek();
+    const PromotedCity &peek() const;
+
+    /**
+     * @brief tryPeek operation, peeking the latest promoted city at the top of the stack without throwing
+              Both time and auxiliary space complexity need to be O(1)
+     * @param
+     * @return pointer to the topmost PromotedCity, valid until the next push or pop,
+     *         or nullptr if the PromotedHouseCityStack is empty
+     */
+    const PromotedCity *tryPeek() const;
 
     /**
      * @brief getHighestPricedPromotedCity,
      *        getting the highest priced city among the past promoted citys
               Both time and auxiliary space complexity need to be O(1)
      * @param
-     * @return PromotedCity
+     * @return PromotedCity, a reference that stays valid until the next push or pop
      *         should throw a logic_error exception with an error message
      *         “Promoted city stack is empty” if the PromotedHouseCityStack is empty
      */
-    PromotedCity getHighestPricedPromotedCity();
+    const PromotedCity &getHighestPricedPromotedCity() const;
 
     /**
      * @brief getLowestPricedPromotedCity,
      *        getting the lowest priced city among the past promoted citys
               Both time and auxiliary space complexity need to be O(1)
      * @param
-     * @return PromotedCity
+     * @return PromotedCity, a reference that stays valid until the next push or pop
      *         should throw a logic_error exception with an error message
      *         “Promoted city stack is empty” if the PromotedHouseCityStack is empty
      */
-    PromotedCity getLowestPricedPromotedCity();
+    const PromotedCity &getLowestPricedPromotedCity() const;
+
+    /**
+     * @brief isEmpty, checking whether there is any promoted city on the stack
+              Both time and auxiliary space complexity need to be O(1)
+     * @param
+     * @return true if the PromotedHouseCityStack is empty
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief isFull, checking whether a bounded stack has reached its capacity
+              Both time and auxiliary space complexity need to be O(1)
+     * @param
+     * @return true if no more cities can be pushed, always false for an unbounded stack
+     */
+    bool isFull() const;
+
+    /**
+     * @brief size, the number of promoted cities on the stack
+              Both time and auxiliary space complexity need to be O(1)
+     * @param
+     * @return size_t
+     */
+    size_t size() const;
 
 };
 
-#endif
\ No newline at end of file
+#endif
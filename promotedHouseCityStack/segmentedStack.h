@@ -0,0 +1,184 @@
+#ifndef SEGMENTEDSTACK_H
+#define SEGMENTEDSTACK_H
+
+#include <stddef.h>
+#include <new>          // placement new
+#include <type_traits>  // aligned_storage
+#include <utility>      // std::forward
+
+using namespace std;
+
+/**
+ * @brief Stack storage made of fixed-size chunks, with worst-case O(1) push and pop.
+ *
+ * Unlike a vector, growing never copies the elements already stored: a full top chunk
+ * is simply followed by another chunk, so elements keep their address for as long as
+ * they are on the stack. Chunks emptied by pops are kept on a free list and handed out
+ * again by later pushes instead of going back to the allocator; they are only released
+ * when the storage itself is destroyed.
+ *
+ * In bounded mode every chunk needed for the fixed capacity is allocated up front, so
+ * pushes never allocate at all; callers must check isFull() before pushing.
+ */
+template <typename T, size_t CHUNK_SIZE = 256>
+class SegmentedStack {
+
+private:
+    struct Chunk {
+        Chunk *prev;    // chunk below this one on the stack
+        Chunk *next;    // chunk above this one on the stack, or the next free chunk
+        typename aligned_storage<sizeof(T), alignof(T)>::type slots[CHUNK_SIZE];
+
+        T *slot(size_t i) {
+            return reinterpret_cast<T *>(&slots[i]);
+        }
+    };
+
+    Chunk *bottom;      // first chunk in use, nullptr before the first push
+    Chunk *top;         // chunk holding the topmost element
+    size_t topCount;    // number of elements stored in the top chunk
+    size_t count;       // number of elements on the stack
+    size_t capacity;    // fixed capacity in bounded mode, 0 when unbounded
+    Chunk *freeChunks;  // recycled chunks, linked through next
+
+    // Take a chunk from the free list, or allocate a new one if the free list is empty
+    Chunk *acquireChunk() {
+        Chunk *chunk = freeChunks;
+        if (chunk != nullptr) {
+            freeChunks = chunk->next;
+        } else {
+            chunk = new Chunk;
+        }
+        chunk->prev = nullptr;
+        chunk->next = nullptr;
+        return chunk;
+    }
+
+    // Put a chunk on the free list so that a later push can reuse it
+    void recycleChunk(Chunk *chunk) {
+        chunk->next = freeChunks;
+        freeChunks = chunk;
+    }
+
+    static void deleteChunks(Chunk *chunk) {
+        while (chunk != nullptr) {
+            Chunk *next = chunk->next;
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+public:
+    // Unbounded mode: chunks are allocated on demand and recycled after popping
+    SegmentedStack()
+        : bottom(nullptr), top(nullptr), topCount(0), count(0), capacity(0), freeChunks(nullptr) {
+    }
+
+    // Bounded mode: all chunks for maxSize elements are allocated here, pushes never allocate
+    explicit SegmentedStack(size_t maxSize)
+        : bottom(nullptr), top(nullptr), topCount(0), count(0), capacity(maxSize), freeChunks(nullptr) {
+        for (size_t reserved = 0; reserved < maxSize; reserved += CHUNK_SIZE) {
+            recycleChunk(new Chunk);
+        }
+    }
+
+    ~SegmentedStack() {
+        while (count > 0) {
+            pop_back();
+        }
+        if (top != nullptr) {
+            top->next = nullptr;
+            deleteChunks(top);
+        }
+        deleteChunks(freeChunks);
+    }
+
+    // Elements are addressed through raw pointers, so the storage itself is not copyable
+    SegmentedStack(const SegmentedStack &) = delete;
+    SegmentedStack &operator=(const SegmentedStack &) = delete;
+
+    /**
+     * @brief construct a new element on top of the stack, worst-case O(1)
+     *        In bounded mode the caller must make sure isFull() is false.
+     */
+    template <typename... Args>
+    void emplace_back(Args &&... args) {
+        if (top == nullptr || topCount == CHUNK_SIZE) {
+            Chunk *chunk = acquireChunk();
+            chunk->prev = top;
+            if (top != nullptr) {
+                top->next = chunk;
+            } else {
+                bottom = chunk;
+            }
+            top = chunk;
+            topCount = 0;
+        }
+        new (top->slot(topCount)) T(std::forward<Args>(args)...);
+        topCount++;
+        count++;
+    }
+
+    /**
+     * @brief destroy the element on top of the stack, worst-case O(1)
+     *        The caller must make sure the stack is not empty.
+     */
+    void pop_back() {
+        topCount--;
+        count--;
+        top->slot(topCount)->~T();
+
+        // Hand an emptied chunk back to the pool, but keep the bottom chunk for the next push
+        if (topCount == 0 && top->prev != nullptr) {
+            Chunk *emptied = top;
+            top = top->prev;
+            top->next = nullptr;
+            topCount = CHUNK_SIZE;
+            recycleChunk(emptied);
+        }
+    }
+
+    T &back() {
+        return *top->slot(topCount - 1);
+    }
+
+    const T &back() const {
+        return *top->slot(topCount - 1);
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // Always false in unbounded mode
+    bool isFull() const {
+        return capacity != 0 && count == capacity;
+    }
+
+    // Fixed capacity in bounded mode, 0 when unbounded
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    /**
+     * @brief call visit(element) on every element, from the bottom of the stack to the top
+     */
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (Chunk *chunk = bottom; chunk != nullptr && count > 0; chunk = chunk->next) {
+            size_t used = (chunk == top) ? topCount : CHUNK_SIZE;
+            for (size_t i = 0; i < used; i++) {
+                visit(*reinterpret_cast<const T *>(&chunk->slots[i]));
+            }
+            if (chunk == top) {
+                break;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,183 @@
+#include "shardedPromotedHouseCityStack.h"
+#include <stdexcept> // header for logic_error exception class
+
+// Node layout: | version (16 bits) | shard (16 bits) | price (32 bits) |
+uint64_t ShardExtremeTree::pack(uint64_t version, uint64_t shard, int price) {
+    return ((version & 0xFFFF) << 48) | ((shard & 0xFFFF) << 32) | (uint64_t)(uint32_t)price;
+}
+
+uint64_t ShardExtremeTree::versionOf(uint64_t node) {
+    return node >> 48;
+}
+
+uint64_t ShardExtremeTree::shardOf(uint64_t node) {
+    return (node >> 32) & 0xFFFF;
+}
+
+int ShardExtremeTree::priceOf(uint64_t node) {
+    return (int)(uint32_t)(node & 0xFFFFFFFF);
+}
+
+/**
+ * @brief the winner of two nodes, an empty node always loses and ties go to the left node
+ */
+uint64_t ShardExtremeTree::better(uint64_t a, uint64_t b) const {
+    if (shardOf(a) == EMPTY_SHARD) {
+        return b;
+    }
+    if (shardOf(b) == EMPTY_SHARD) {
+        return a;
+    }
+    if (preferHigher) {
+        return (priceOf(b) > priceOf(a)) ? b : a;
+    }
+    return (priceOf(b) < priceOf(a)) ? b : a;
+}
+
+/**
+ * @brief recompute an internal node from its children and try to install it
+ * @return false if another writer replaced the node in the meantime
+ */
+bool ShardExtremeTree::refresh(size_t node) {
+    uint64_t old = nodes[node].load();
+    uint64_t winner = better(nodes[2 * node].load(), nodes[2 * node + 1].load());
+    uint64_t updated = pack(versionOf(old) + 1, shardOf(winner), priceOf(winner));
+    return nodes[node].compare_exchange_strong(old, updated);
+}
+
+ShardExtremeTree::ShardExtremeTree(int numShards, bool preferHigher)
+    : preferHigher(preferHigher), leafBase(1), nodes() {
+
+    // Round the number of leaves up to a power of two so that node i has children 2i and 2i + 1
+    while (leafBase < (size_t)numShards) {
+        leafBase *= 2;
+    }
+
+    // Every node starts out empty, the vector is sized once and never reallocated
+    vector<atomic<uint64_t> > emptyNodes(2 * leafBase);
+    nodes.swap(emptyNodes);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes[i].store(pack(0, EMPTY_SHARD, 0));
+    }
+}
+
+void ShardExtremeTree::publish(int shard, bool isEmpty, int price) {
+
+    // Only the shard's writer stores its leaf, so a plain store is enough here
+    size_t node = leafBase + shard;
+    uint64_t old = nodes[node].load();
+    nodes[node].store(pack(versionOf(old) + 1, isEmpty ? EMPTY_SHARD : (uint64_t)shard, price));
+
+    // Propagate the change up to the root, refreshing each ancestor twice
+    for (node /= 2; node >= 1; node /= 2) {
+        if (!refresh(node)) {
+            refresh(node);
+        }
+    }
+}
+
+int ShardExtremeTree::getExtremeShard() const {
+    uint64_t root = nodes[1].load();
+    return (shardOf(root) == EMPTY_SHARD) ? NO_SHARD : (int)shardOf(root);
+}
+
+bool ShardExtremeTree::getExtremePrice(int &price) const {
+    uint64_t root = nodes[1].load();
+    if (shardOf(root) == EMPTY_SHARD) {
+        return false;
+    }
+    price = priceOf(root);
+    return true;
+}
+
+/**
+ * @brief validate the number of shards before any member is sized from it
+ * @throws invalid_argument if numShards is out of range
+ */
+int ShardedPromotedHouseCityStack::checkNumShards(int numShards) {
+
+    // Shard indices are packed into 16 bits of a tree node, and 0xFFFF marks an empty node
+    if (numShards < 1 || numShards > 0xFFFF) {
+        throw invalid_argument("Number of shards must be between 1 and 65535");
+    }
+    return numShards;
+}
+
+ShardedPromotedHouseCityStack::ShardedPromotedHouseCityStack(int numShards)
+    : shards(checkNumShards(numShards)),
+      highestPrices(numShards, true),
+      lowestPrices(numShards, false) {
+}
+
+int ShardedPromotedHouseCityStack::getNumShards() const {
+    return (int)shards.size();
+}
+
+ShardedPromotedHouseCityStack::Shard &ShardedPromotedHouseCityStack::shardAt(int shard) {
+    if (shard < 0 || shard >= (int)shards.size()) {
+        throw out_of_range("Shard index out of range");
+    }
+    return shards[shard];
+}
+
+/**
+ * @brief publish the current highest and lowest prices of a shard into the tournament trees
+ */
+void ShardedPromotedHouseCityStack::publishShard(int shard) {
+    const PromotedHouseCityStack &stack = shards[shard].stack;
+
+    if (stack.isEmpty()) {
+        highestPrices.publish(shard, true, 0);
+        lowestPrices.publish(shard, true, 0);
+    } else {
+        highestPrices.publish(shard, false, stack.getHighestPricedPromotedCity().getPromotedPrice());
+        lowestPrices.publish(shard, false, stack.getLowestPricedPromotedCity().getPromotedPrice());
+    }
+}
+
+void ShardedPromotedHouseCityStack::push(int shard, string city, int price) {
+    shardAt(shard).stack.push(city, price);
+    publishShard(shard);
+}
+
+PromotedCity ShardedPromotedHouseCityStack::pop(int shard) {
+    PromotedCity promotedCity = shardAt(shard).stack.pop();
+    publishShard(shard);
+    return promotedCity;
+}
+
+bool ShardedPromotedHouseCityStack::tryPop(int shard, PromotedCity &promotedCity) {
+    if (!shardAt(shard).stack.tryPop(promotedCity)) {
+        return false;
+    }
+    publishShard(shard);
+    return true;
+}
+
+const PromotedCity &ShardedPromotedHouseCityStack::peek(int shard) {
+    return shardAt(shard).stack.peek();
+}
+
+int ShardedPromotedHouseCityStack::getHighestPromotedPrice() const {
+    int price;
+    if (!highestPrices.getExtremePrice(price)) {
+        throw logic_error("Promoted house city stack is empty");
+    }
+    return price;
+}
+
+int ShardedPromotedHouseCityStack::getLowestPromotedPrice() const {
+    int price;
+    if (!lowestPrices.getExtremePrice(price)) {
+        throw logic_error("Promoted house city stack is empty");
+    }
+    return price;
+}
+
+int ShardedPromotedHouseCityStack::getHighestPricedShard() const {
+    return highestPrices.getExtremeShard();
+}
+
+int ShardedPromotedHouseCityStack::getLowestPricedShard() const {
+    return lowestPrices.getExtremeShard();
+}
@@ -0,0 +1,176 @@
+#ifndef SHARDEDPROMOTEDHOUSECITYSTACK_H
+#define SHARDEDPROMOTEDHOUSECITYSTACK_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "promotedHouseCityStack.h"
+
+using namespace std;
+
+/**
+ * @brief Tournament tree over the per-shard price extremes.
+ *
+ * Each leaf holds the current extreme (highest or lowest) price of one shard, and each
+ * internal node holds the winner of its two children, so the root is the global extreme.
+ *
+ * A node is a single 64-bit word packing a 16-bit version, a 16-bit shard index and the
+ * 32-bit price, so it can be read and replaced atomically. Each shard has exactly one writer,
+ * which stores its leaf and then refreshes every node on the path to the root. Writers of
+ * different shards never block each other: a refresh recomputes a node from its children
+ * and installs it with compare-and-swap, and each node is refreshed twice, so even when
+ * both attempts lose a race the winning refresh has already seen this writer's leaf.
+ * The version counter keeps a stale compare-and-swap from succeeding after the node
+ * was changed and changed back.
+ */
+class ShardExtremeTree {
+
+private:
+    bool preferHigher;                  // true for a max tree, false for a min tree
+    size_t leafBase;                    // index of the first leaf (a power of two)
+    vector<atomic<uint64_t> > nodes;    // 1-based heap layout, nodes[1] is the root
+
+    static const uint64_t EMPTY_SHARD = 0xFFFF;
+
+    static uint64_t pack(uint64_t version, uint64_t shard, int price);
+    static uint64_t versionOf(uint64_t node);
+    static uint64_t shardOf(uint64_t node);
+    static int priceOf(uint64_t node);
+
+    uint64_t better(uint64_t a, uint64_t b) const;
+    bool refresh(size_t node);
+
+public:
+    static const int NO_SHARD = -1;
+
+    ShardExtremeTree(int numShards, bool preferHigher);
+
+    /**
+     * @brief publish the current extreme of a shard, only called by the shard's writer
+     * @param shard
+     * @param isEmpty true if the shard holds no promoted cities
+     * @param price   the shard's current extreme price, ignored when isEmpty
+     */
+    void publish(int shard, bool isEmpty, int price);
+
+    /**
+     * @brief the shard holding the global extreme price, O(1) and lock free
+     * @return shard index, or NO_SHARD if every shard is empty
+     */
+    int getExtremeShard() const;
+
+    /**
+     * @brief read the global extreme price, O(1) and lock free
+     * @param price set to the global extreme price if any shard is non-empty
+     * @return false if every shard is empty
+     */
+    bool getExtremePrice(int &price) const;
+};
+
+/**
+ * @brief A set of independent PromotedHouseCityStacks (e.g. one per region or per thread)
+ *        with O(1) global highest / lowest price queries.
+ *
+ * Every shard must be updated by a single writer thread at a time; different shards can be
+ * pushed and popped concurrently without any locking. After each push / pop, the writer
+ * publishes the shard's highest and lowest prices into two ShardExtremeTrees, which costs
+ * O(log shards), and any thread can read the global extremes from the tree roots in O(1).
+ *
+ * The global queries report the winning price and the shard that holds it. The city itself
+ * lives in that shard's stack, which only its writer may read while writers are running.
+ */
+class ShardedPromotedHouseCityStack {
+
+private:
+    // Pad every shard to its own cache lines so neighbouring writers do not false share
+    struct Shard {
+        PromotedHouseCityStack stack;
+        char padding[64];
+    };
+
+    vector<Shard> shards;
+    ShardExtremeTree highestPrices;
+    ShardExtremeTree lowestPrices;
+
+    static int checkNumShards(int numShards);
+    Shard &shardAt(int shard);
+    void publishShard(int shard);
+
+public:
+    static const int NO_SHARD = ShardExtremeTree::NO_SHARD;
+
+    /**
+     * @brief create numShards empty stacks
+     * @param numShards between 1 and 65535
+     * @throws invalid_argument if numShards is out of range
+     */
+    explicit ShardedPromotedHouseCityStack(int numShards);
+
+    int getNumShards() const;
+
+    /**
+     * @brief push a promoted city onto one shard, O(log shards)
+     * @param shard
+     * @param city
+     * @param price
+     * @throws out_of_range if shard is not a valid shard index
+     */
+    void push(int shard, string city, int price);
+
+    /**
+     * @brief pop the latest promoted city off one shard, O(log shards)
+     * @param shard
+     * @return PromotedCity
+     * @throws out_of_range if shard is not a valid shard index
+     * @throws logic_error if the shard is empty
+     */
+    PromotedCity pop(int shard);
+
+    /**
+     * @brief pop the latest promoted city off one shard without throwing on an empty shard
+     * @param shard
+     * @param promotedCity receives the popped PromotedCity, untouched if the shard is empty
+     * @return false if the shard is empty
+     * @throws out_of_range if shard is not a valid shard index
+     */
+    bool tryPop(int shard, PromotedCity &promotedCity);
+
+    /**
+     * @brief peek the latest promoted city of one shard, O(1)
+     * @param shard
+     * @return PromotedCity, a reference that stays valid until the shard's next push or pop
+     * @throws out_of_range if shard is not a valid shard index
+     * @throws logic_error if the shard is empty
+     */
+    const PromotedCity &peek(int shard);
+
+    /**
+     * @brief highest price among all shards, O(1)
+     * @return price
+     * @throws logic_error if every shard is empty
+     */
+    int getHighestPromotedPrice() const;
+
+    /**
+     * @brief lowest price among all shards, O(1)
+     * @return price
+     * @throws logic_error if every shard is empty
+     */
+    int getLowestPromotedPrice() const;
+
+    /**
+     * @brief shard holding the highest price among all shards, O(1)
+     * @return shard index, or NO_SHARD if every shard is empty
+     */
+    int getHighestPricedShard() const;
+
+    /**
+     * @brief shard holding the lowest price among all shards, O(1)
+     * @return shard index, or NO_SHARD if every shard is empty
+     */
+    int getLowestPricedShard() const;
+};
+
+#endif